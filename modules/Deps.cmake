@@ -112,9 +112,3 @@ CPMAddPackage(
         OPTIONS
         "BUILD_SHARED_LIBS OFF"
 )
-
-CPMAddPackage(
-        NAME tiny-process-library
-        GIT_REPOSITORY https://gitlab.com/eidheim/tiny-process-library
-        GIT_TAG 8bbb5a211c5c9df8ee69301da9d22fb977b27dc1
-)
\ No newline at end of file
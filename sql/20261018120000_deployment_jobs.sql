@@ -0,0 +1,15 @@
+CREATE TABLE deployment_job
+(
+    id         bigserial PRIMARY KEY,
+    project_id text         NOT NULL REFERENCES project (id) ON DELETE CASCADE,
+    user_id    text REFERENCES user_ (id) ON DELETE SET NULL,
+    priority   int          NOT NULL DEFAULT 0,
+    status     varchar(255) NOT NULL DEFAULT 'queued',
+
+    created_at timestamp(3) NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    started_at timestamp(3)
+);
+
+-- Coalesce pending deployments per project
+CREATE UNIQUE INDEX deployment_job_queued_project ON deployment_job (project_id) WHERE status = 'queued';
+CREATE INDEX deployment_job_next ON deployment_job (priority DESC, created_at) WHERE status = 'queued';
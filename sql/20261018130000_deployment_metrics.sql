@@ -0,0 +1,2 @@
+-- Per-stage timings and resource usage recorded while deploying
+ALTER TABLE deployment ADD COLUMN metrics jsonb;
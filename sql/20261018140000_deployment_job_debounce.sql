@@ -0,0 +1,2 @@
+-- Jobs triggered by pushes wait for the burst to settle before they are started
+ALTER TABLE deployment_job ADD COLUMN run_after timestamp(3) NOT NULL DEFAULT CURRENT_TIMESTAMP;
@@ -0,0 +1,7 @@
+-- Deployments ingest into a staging version that only becomes visible once the deployment is activated.
+-- Replaced versions are retired and removed later by a background job, so readers never wait on ingestion.
+ALTER TABLE project_version ADD COLUMN live bool NOT NULL DEFAULT true;
+ALTER TABLE project_version ADD COLUMN retired_at timestamp(3);
+
+CREATE UNIQUE INDEX project_version_live_default ON project_version (project_id) WHERE name IS NULL AND live;
+CREATE INDEX project_version_retired ON project_version (retired_at) WHERE retired_at IS NOT NULL;
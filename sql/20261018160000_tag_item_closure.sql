@@ -0,0 +1,56 @@
+-- The flattened tag -> item relation is maintained per project version instead of refreshing a view over all projects
+DROP MATERIALIZED VIEW tag_item_flat;
+
+CREATE TABLE tag_item_flat
+(
+    parent bigint NOT NULL REFERENCES project_tag (id) ON DELETE CASCADE,
+    child  bigint NOT NULL REFERENCES project_item (id) ON DELETE CASCADE,
+
+    PRIMARY KEY (parent, child)
+);
+
+CREATE INDEX tag_item_flat_child ON tag_item_flat (child);
+
+-- Tags of a version, along with tags of other versions that include them
+CREATE FUNCTION tag_item_flat_affected(version bigint) RETURNS SETOF bigint AS
+$BODY$
+WITH RECURSIVE affected(id) AS (SELECT id
+                                FROM project_tag
+                                WHERE version_id = version
+                                UNION
+                                SELECT tag_tag.parent
+                                FROM tag_tag
+                                         JOIN affected ON tag_tag.child = affected.id)
+SELECT id
+FROM affected;
+$BODY$ LANGUAGE sql STABLE;
+
+-- Recomputes flattened items of all tags affected by changes to a version
+CREATE FUNCTION refresh_tag_item_flat(version bigint) RETURNS void AS
+$BODY$
+DELETE
+FROM tag_item_flat
+WHERE parent IN (SELECT tag_item_flat_affected(version));
+
+INSERT INTO tag_item_flat (parent, child)
+WITH RECURSIVE reachable(parent, tag) AS (SELECT id, id
+                                          FROM tag_item_flat_affected(version) AS id
+                                          UNION
+                                          SELECT reachable.parent, tag_tag.child
+                                          FROM reachable
+                                                   JOIN tag_tag ON tag_tag.parent = reachable.tag)
+SELECT DISTINCT reachable.parent, tag_item.item_id
+FROM reachable
+         JOIN tag_item ON tag_item.tag_id = reachable.tag;
+$BODY$ LANGUAGE sql;
+
+INSERT INTO tag_item_flat (parent, child)
+WITH RECURSIVE reachable(parent, tag) AS (SELECT id, id
+                                          FROM project_tag
+                                          UNION
+                                          SELECT reachable.parent, tag_tag.child
+                                          FROM reachable
+                                                   JOIN tag_tag ON tag_tag.parent = reachable.tag)
+SELECT DISTINCT reachable.parent, tag_item.item_id
+FROM reachable
+         JOIN tag_item ON tag_item.tag_id = reachable.tag;
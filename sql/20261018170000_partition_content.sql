@@ -0,0 +1,350 @@
+-- Content tables are partitioned by project version. Every version holding content gets partitions of its own,
+-- so that retiring a version detaches and drops them instead of deleting its rows one by one.
+-- There are no default partitions, content of a version without partitions is rejected instead of piling up in a
+-- table that every new partition would have to scan.
+-- Partition keys must be part of every unique key, references between content rows therefore include the version.
+
+CREATE TEMPORARY TABLE project_item_data AS SELECT * FROM project_item;
+CREATE TEMPORARY TABLE project_item_page_data AS SELECT * FROM project_item_page;
+CREATE TEMPORARY TABLE project_tag_data AS SELECT * FROM project_tag;
+CREATE TEMPORARY TABLE tag_item_data AS SELECT * FROM tag_item;
+CREATE TEMPORARY TABLE tag_tag_data AS SELECT * FROM tag_tag;
+CREATE TEMPORARY TABLE recipe_type_data AS SELECT * FROM recipe_type;
+CREATE TEMPORARY TABLE recipe_data AS SELECT * FROM recipe;
+CREATE TEMPORARY TABLE recipe_ingredient_item_data AS SELECT * FROM recipe_ingredient_item;
+CREATE TEMPORARY TABLE recipe_ingredient_tag_data AS SELECT * FROM recipe_ingredient_tag;
+CREATE TEMPORARY TABLE recipe_workbench_data AS SELECT * FROM recipe_workbench;
+
+-- Keep id sequences alive while their tables are recreated
+ALTER SEQUENCE project_item_id_seq OWNED BY NONE;
+ALTER SEQUENCE project_tag_id_seq OWNED BY NONE;
+ALTER SEQUENCE recipe_type_id_seq OWNED BY NONE;
+ALTER SEQUENCE recipe_id_seq OWNED BY NONE;
+
+DROP TABLE tag_item_flat, recipe_workbench, recipe_ingredient_tag, recipe_ingredient_item, recipe, recipe_type,
+    tag_tag, tag_item, project_tag, project_item_page, project_item;
+
+CREATE TABLE project_item
+(
+    id         bigint NOT NULL DEFAULT nextval('project_item_id_seq'),
+    item_id    bigint NOT NULL REFERENCES item (id) ON DELETE CASCADE,
+    version_id bigint NOT NULL REFERENCES project_version (id) ON DELETE CASCADE,
+
+    PRIMARY KEY (id, version_id),
+    UNIQUE (item_id, version_id)
+) PARTITION BY LIST (version_id);
+
+CREATE INDEX project_item_version ON project_item (version_id);
+
+CREATE TABLE project_item_page
+(
+    item_id    bigint NOT NULL,
+    version_id bigint NOT NULL,
+    path       text   NOT NULL,
+
+    FOREIGN KEY (item_id, version_id) REFERENCES project_item (id, version_id) ON DELETE CASCADE
+) PARTITION BY LIST (version_id);
+
+CREATE INDEX project_item_page_item ON project_item_page (item_id, version_id);
+
+CREATE TABLE project_tag
+(
+    id         bigint NOT NULL DEFAULT nextval('project_tag_id_seq'),
+    tag_id     bigint NOT NULL REFERENCES tag (id) ON DELETE CASCADE,
+    version_id bigint NOT NULL REFERENCES project_version (id) ON DELETE CASCADE,
+
+    PRIMARY KEY (id, version_id),
+    UNIQUE (tag_id, version_id)
+) PARTITION BY LIST (version_id);
+
+CREATE INDEX project_tag_version ON project_tag (version_id);
+
+CREATE TABLE tag_item
+(
+    tag_id          bigint NOT NULL,
+    version_id      bigint NOT NULL,
+    item_id         bigint NOT NULL,
+    item_version_id bigint NOT NULL,
+
+    PRIMARY KEY (tag_id, version_id, item_id),
+    FOREIGN KEY (tag_id, version_id) REFERENCES project_tag (id, version_id) ON DELETE CASCADE,
+    FOREIGN KEY (item_id, item_version_id) REFERENCES project_item (id, version_id) ON DELETE CASCADE
+) PARTITION BY LIST (version_id);
+
+CREATE INDEX tag_item_item ON tag_item (item_id, item_version_id);
+
+CREATE TABLE tag_tag
+(
+    parent           bigint NOT NULL,
+    version_id       bigint NOT NULL,
+    child            bigint NOT NULL,
+    child_version_id bigint NOT NULL,
+
+    PRIMARY KEY (parent, version_id, child),
+    FOREIGN KEY (parent, version_id) REFERENCES project_tag (id, version_id) ON DELETE CASCADE,
+    FOREIGN KEY (child, child_version_id) REFERENCES project_tag (id, version_id) ON DELETE CASCADE,
+    CHECK (parent <> child)
+) PARTITION BY LIST (version_id);
+
+CREATE INDEX tag_tag_child ON tag_tag (child, child_version_id);
+
+CREATE TRIGGER before_insert_tag_tag_trg
+    BEFORE INSERT
+    ON tag_tag
+    FOR EACH ROW
+EXECUTE PROCEDURE tags_insert_trigger_func();
+
+CREATE TABLE recipe_type
+(
+    id         bigint NOT NULL DEFAULT nextval('recipe_type_id_seq'),
+    loc        resource_location,
+    version_id bigint NOT NULL REFERENCES project_version (id) ON DELETE CASCADE,
+
+    PRIMARY KEY (id, version_id)
+) PARTITION BY LIST (version_id);
+
+CREATE INDEX recipe_type_version ON recipe_type (version_id, loc);
+
+CREATE TABLE recipe
+(
+    id              bigint            NOT NULL DEFAULT nextval('recipe_id_seq'),
+    version_id      bigint            NOT NULL REFERENCES project_version (id) ON DELETE CASCADE,
+    loc             resource_location NOT NULL,
+    type_id         bigint            NOT NULL,
+    type_version_id bigint            NOT NULL,
+
+    PRIMARY KEY (id, version_id),
+    UNIQUE (version_id, loc),
+    FOREIGN KEY (type_id, type_version_id) REFERENCES recipe_type (id, version_id) ON DELETE CASCADE
+) PARTITION BY LIST (version_id);
+
+CREATE INDEX recipe_type_ref ON recipe (type_id, type_version_id);
+
+CREATE TABLE recipe_ingredient_tag
+(
+    recipe_id  bigint       NOT NULL,
+    version_id bigint       NOT NULL,
+    tag_id     bigint       NOT NULL REFERENCES tag (id) ON DELETE CASCADE,
+    slot       varchar(255) NOT NULL,
+    count      int          NOT NULL,
+    input      bool         NOT NULL,
+
+    PRIMARY KEY (recipe_id, version_id, tag_id, slot, input),
+    FOREIGN KEY (recipe_id, version_id) REFERENCES recipe (id, version_id) ON DELETE CASCADE
+) PARTITION BY LIST (version_id);
+
+CREATE TABLE recipe_ingredient_item
+(
+    recipe_id  bigint       NOT NULL,
+    version_id bigint       NOT NULL,
+    item_id    bigint       NOT NULL REFERENCES item (id) ON DELETE CASCADE,
+    slot       varchar(255) NOT NULL,
+    count      int          NOT NULL,
+    input      bool         NOT NULL,
+
+    PRIMARY KEY (recipe_id, version_id, item_id, slot, input),
+    FOREIGN KEY (recipe_id, version_id) REFERENCES recipe (id, version_id) ON DELETE CASCADE
+) PARTITION BY LIST (version_id);
+
+CREATE TABLE recipe_workbench
+(
+    type_id         bigint NOT NULL,
+    version_id      bigint NOT NULL,
+    item_id         bigint NOT NULL,
+    item_version_id bigint NOT NULL,
+
+    PRIMARY KEY (type_id, version_id, item_id),
+    FOREIGN KEY (type_id, version_id) REFERENCES recipe_type (id, version_id) ON DELETE CASCADE,
+    FOREIGN KEY (item_id, item_version_id) REFERENCES project_item (id, version_id) ON DELETE CASCADE
+) PARTITION BY LIST (version_id);
+
+CREATE INDEX recipe_workbench_item ON recipe_workbench (item_id, item_version_id);
+
+CREATE TABLE tag_item_flat
+(
+    parent           bigint NOT NULL,
+    version_id       bigint NOT NULL,
+    child            bigint NOT NULL,
+    child_version_id bigint NOT NULL,
+
+    PRIMARY KEY (parent, version_id, child),
+    FOREIGN KEY (parent, version_id) REFERENCES project_tag (id, version_id) ON DELETE CASCADE,
+    FOREIGN KEY (child, child_version_id) REFERENCES project_item (id, version_id) ON DELETE CASCADE
+) PARTITION BY LIST (version_id);
+
+CREATE INDEX tag_item_flat_child ON tag_item_flat (child, child_version_id);
+
+ALTER SEQUENCE project_item_id_seq OWNED BY project_item.id;
+ALTER SEQUENCE project_tag_id_seq OWNED BY project_tag.id;
+ALTER SEQUENCE recipe_type_id_seq OWNED BY recipe_type.id;
+ALTER SEQUENCE recipe_id_seq OWNED BY recipe.id;
+
+-- Parents come before the tables referencing them, partitions are dropped in reverse order
+CREATE FUNCTION content_partitioned_tables() RETURNS text[] AS
+$BODY$
+SELECT ARRAY ['project_item', 'project_tag', 'recipe_type', 'project_item_page', 'tag_item', 'tag_tag', 'recipe',
+    'recipe_ingredient_tag', 'recipe_ingredient_item', 'recipe_workbench', 'tag_item_flat'];
+$BODY$ LANGUAGE sql IMMUTABLE;
+
+-- Partitions are created on their own and then attached, which only takes a SHARE UPDATE EXCLUSIVE lock on the parent
+-- instead of the ACCESS EXCLUSIVE lock of CREATE TABLE ... PARTITION OF, so readers and writers of other versions
+-- are not blocked. Cloning foreign keys onto the new partition briefly blocks writes to the referenced tables.
+CREATE FUNCTION create_version_partitions(version bigint) RETURNS void AS
+$BODY$
+DECLARE
+    parent    text;
+    partition text;
+BEGIN
+    FOREACH parent IN ARRAY content_partitioned_tables()
+        LOOP
+            partition := parent || '_v' || version;
+            IF to_regclass(quote_ident(partition)) IS NULL THEN
+                EXECUTE format('CREATE TABLE %I (LIKE %I INCLUDING DEFAULTS INCLUDING CONSTRAINTS)', partition, parent);
+                EXECUTE format('ALTER TABLE %I ATTACH PARTITION %I FOR VALUES IN (%s)', parent, partition, version);
+            END IF;
+        END LOOP;
+END;
+$BODY$ LANGUAGE plpgsql;
+
+-- Drops the version's own partitions along with its row.
+-- Detaching takes an ACCESS EXCLUSIVE lock on each parent. Rather than queueing every reader behind it while a long
+-- query finishes, the deletion gives up after a short wait and is retried by the next cleanup run.
+CREATE FUNCTION delete_project_version(version bigint) RETURNS void AS
+$BODY$
+DECLARE
+    parent    text;
+    partition text;
+BEGIN
+    PERFORM set_config('lock_timeout', '2s', true);
+
+    FOR parent IN SELECT t FROM unnest(content_partitioned_tables()) WITH ORDINALITY AS p(t, i) ORDER BY i DESC
+        LOOP
+            partition := parent || '_v' || version;
+            IF to_regclass(quote_ident(partition)) IS NOT NULL THEN
+                EXECUTE format('ALTER TABLE %I DETACH PARTITION %I', parent, partition);
+                EXECUTE format('DROP TABLE %I', partition);
+            END IF;
+        END LOOP;
+
+    DELETE FROM project_version WHERE id = version;
+END;
+$BODY$ LANGUAGE plpgsql;
+
+-- Content of existing versions moves into partitions of their own. Default versions get partitions even when empty,
+-- the game's version is filled by data imports rather than staged deployments.
+SELECT create_version_partitions(id)
+FROM project_version
+WHERE name IS NULL
+   OR id IN (SELECT version_id FROM project_item_data
+             UNION
+             SELECT version_id FROM project_tag_data
+             UNION
+             SELECT version_id FROM recipe_type_data
+             UNION
+             SELECT version_id FROM recipe_data);
+
+-- Restore existing content
+INSERT INTO project_item (id, item_id, version_id)
+SELECT id, item_id, version_id
+FROM project_item_data;
+
+INSERT INTO project_item_page (item_id, version_id, path)
+SELECT d.item_id, pitem.version_id, d.path
+FROM project_item_page_data d
+         JOIN project_item pitem ON pitem.id = d.item_id;
+
+INSERT INTO project_tag (id, tag_id, version_id)
+SELECT id, tag_id, version_id
+FROM project_tag_data;
+
+INSERT INTO tag_item (tag_id, version_id, item_id, item_version_id)
+SELECT d.tag_id, ptag.version_id, d.item_id, pitem.version_id
+FROM tag_item_data d
+         JOIN project_tag ptag ON ptag.id = d.tag_id
+         JOIN project_item pitem ON pitem.id = d.item_id;
+
+INSERT INTO tag_tag (parent, version_id, child, child_version_id)
+SELECT d.parent, tp.version_id, d.child, tc.version_id
+FROM tag_tag_data d
+         JOIN project_tag tp ON tp.id = d.parent
+         JOIN project_tag tc ON tc.id = d.child;
+
+INSERT INTO recipe_type (id, loc, version_id)
+SELECT id, loc, version_id
+FROM recipe_type_data;
+
+-- Recipes without a version predate virtual projects and belong to the game. Moving them must not silently drop
+-- recipes that the game's version already defines under the same location.
+UPDATE recipe_data
+SET version_id = (SELECT id FROM project_version WHERE project_id = 'minecraft' AND name IS NULL)
+WHERE version_id IS NULL;
+
+DO
+$$
+DECLARE
+    conflicts bigint;
+BEGIN
+    SELECT count(*)
+    INTO conflicts
+    FROM (SELECT version_id, loc FROM recipe_data GROUP BY version_id, loc HAVING count(*) > 1) duplicate;
+
+    IF conflicts > 0 THEN
+        RAISE EXCEPTION '% recipe locations are defined more than once per version, resolve them before migrating', conflicts;
+    END IF;
+END
+$$;
+
+INSERT INTO recipe (id, version_id, loc, type_id, type_version_id)
+SELECT d.id, d.version_id, d.loc, d.type_id, rt.version_id
+FROM recipe_data d
+         JOIN recipe_type rt ON rt.id = d.type_id;
+
+INSERT INTO recipe_ingredient_tag (recipe_id, version_id, tag_id, slot, count, input)
+SELECT d.recipe_id, r.version_id, d.tag_id, d.slot, d.count, d.input
+FROM recipe_ingredient_tag_data d
+         JOIN recipe r ON r.id = d.recipe_id;
+
+INSERT INTO recipe_ingredient_item (recipe_id, version_id, item_id, slot, count, input)
+SELECT d.recipe_id, r.version_id, d.item_id, d.slot, d.count, d.input
+FROM recipe_ingredient_item_data d
+         JOIN recipe r ON r.id = d.recipe_id;
+
+INSERT INTO recipe_workbench (type_id, version_id, item_id, item_version_id)
+SELECT d.type_id, rt.version_id, d.item_id, pitem.version_id
+FROM recipe_workbench_data d
+         JOIN recipe_type rt ON rt.id = d.type_id
+         JOIN project_item pitem ON pitem.id = d.item_id;
+
+DROP TABLE project_item_data, project_item_page_data, project_tag_data, tag_item_data, tag_tag_data, recipe_type_data, recipe_data,
+    recipe_ingredient_item_data, recipe_ingredient_tag_data, recipe_workbench_data;
+
+-- Flattened entries now carry the versions of both sides
+CREATE OR REPLACE FUNCTION refresh_tag_item_flat(version bigint) RETURNS void AS
+$BODY$
+DELETE
+FROM tag_item_flat
+WHERE parent IN (SELECT tag_item_flat_affected(version));
+
+INSERT INTO tag_item_flat (parent, version_id, child, child_version_id)
+WITH RECURSIVE reachable(parent, version_id, tag) AS (SELECT ptag.id, ptag.version_id, ptag.id
+                                                      FROM project_tag ptag
+                                                      WHERE ptag.id IN (SELECT tag_item_flat_affected(version))
+                                                      UNION
+                                                      SELECT reachable.parent, reachable.version_id, tag_tag.child
+                                                      FROM reachable
+                                                               JOIN tag_tag ON tag_tag.parent = reachable.tag)
+SELECT DISTINCT reachable.parent, reachable.version_id, tag_item.item_id, tag_item.item_version_id
+FROM reachable
+         JOIN tag_item ON tag_item.tag_id = reachable.tag;
+$BODY$ LANGUAGE sql;
+
+INSERT INTO tag_item_flat (parent, version_id, child, child_version_id)
+WITH RECURSIVE reachable(parent, version_id, tag) AS (SELECT id, version_id, id
+                                                      FROM project_tag
+                                                      UNION
+                                                      SELECT reachable.parent, reachable.version_id, tag_tag.child
+                                                      FROM reachable
+                                                               JOIN tag_tag ON tag_tag.parent = reachable.tag)
+SELECT DISTINCT reachable.parent, reachable.version_id, tag_item.item_id, tag_item.item_version_id
+FROM reachable
+         JOIN tag_item ON tag_item.tag_id = reachable.tag;
@@ -0,0 +1,3 @@
+-- Staging versions remember the deployment ingesting into them, so that starting a deployment only retires
+-- versions left behind by deployments that are no longer running
+ALTER TABLE project_version ADD COLUMN deployment_id varchar(28) REFERENCES deployment (id) ON DELETE SET NULL;
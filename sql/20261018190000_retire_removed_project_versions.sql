@@ -0,0 +1,7 @@
+-- Versions of removed projects are retired rather than deleted with the project, so that their partitions are dropped
+-- by the background job one version at a time, which retries versions that time out waiting for their locks.
+ALTER TABLE project_version ALTER COLUMN project_id DROP NOT NULL;
+
+ALTER TABLE project_version
+    DROP CONSTRAINT project_version_project_id_fkey,
+    ADD CONSTRAINT project_version_project_id_fkey FOREIGN KEY (project_id) REFERENCES project (id) ON DELETE SET NULL;
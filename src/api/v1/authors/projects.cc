@@ -6,6 +6,7 @@
 #include <schemas/schemas.h>
 #include <service/auth.h>
 #include <service/error.h>
+#include <service/file_io.h>
 #include <service/project/cached/cached.h>
 #include <service/storage/deployment.h>
 #include <service/storage/management/project_access.h>
@@ -48,10 +49,18 @@ namespace api::v1 {
         const auto session(co_await global::auth->getSession(req));
         const auto projects = co_await global::database->getUserProjects(session.username);
 
+        std::vector<std::string> projectIds;
+        for (const auto &project: projects) {
+            projectIds.push_back(project.getValueOfId());
+        }
+        const auto summaries = co_await global::database->getProjectSummaries(projectIds);
+
         Json::Value projectsJson(Json::arrayValue);
         for (const auto &project: projects) {
             Json::Value json = projectToJson(project, true);
-            json["status"] = enumToStr(co_await global::storage->getProjectStatus(project));
+            const auto summary = summaries.find(project.getValueOfId());
+            json["status"] = enumToStr(summary != summaries.end() ? co_await global::storage->getProjectStatus(project, summary->second)
+                                                                   : ProjectStatus::UNKNOWN);
             projectsJson.append(json);
         }
 
@@ -201,7 +210,6 @@ namespace api::v1 {
         }
 
         global::storage->invalidateProject(project);
-        co_await global::database->refreshFlatTagItemView();
         co_await clearProjectCache(project.getValueOfId());
 
         callback(simpleResponse("Project deleted successfully"));
@@ -431,7 +439,7 @@ namespace api::v1 {
         const std::string path = json.contains("path") ? json["path"] : "";
         auto resolvedPath = path;
         if (!path.empty()) {
-            const auto filePath = resolved->getPagePath(path);
+            const auto filePath = co_await supplyFileIO<std::optional<std::string>>([&] { return resolved->getPagePath(path); });
             if (!filePath) {
                 throw ApiException(Error::ErrBadRequest, "invalid_path");
             }
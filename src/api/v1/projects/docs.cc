@@ -36,7 +36,7 @@ namespace api::v1 {
         const auto resolved = co_await BaseProjectController::getProjectWithParams(req, project);
         requireNonVirtual(resolved);
 
-        const auto page(resolved->readPageFile(path + DOCS_FILE_EXT));
+        const auto page(co_await resolved->readPageFile(path + DOCS_FILE_EXT));
         if (!page) {
             const auto optionalParam = req->getOptionalParameter<std::string>("optional");
             const auto optional = optionalParam.has_value() && optionalParam == "true";
@@ -83,7 +83,7 @@ namespace api::v1 {
             throw ApiException(Error::ErrBadRequest, "Invalid location specified");
         }
 
-        const auto asset = resolved->getAsset(*resourceLocation);
+        const auto asset = co_await resolved->getAsset(*resourceLocation);
         if (!asset) {
             const auto optionalParam = req->getOptionalParameter<std::string>("optional");
             const auto optional = optionalParam.has_value() && optionalParam == "true";
@@ -12,6 +12,7 @@
 #include <service/external/crowdin.h>
 #include <service/system/access_keys.h>
 #include <service/system/lang.h>
+#include <service/storage/deployment_queue.h>
 #include "base.h"
 #include "system/game_data.h"
 
@@ -69,6 +70,7 @@ namespace api::v1 {
         const auto latestImport = imports.size > 0 ? imports.data.front() : nlohmann::json{nullptr};
         const auto projectCount{co_await global::database->getTotalModelCount<Project>()};
         const auto userCount{co_await global::database->getTotalModelCount<User>()};
+        const auto deploymentStats{co_await global::deployments->getStats()};
 
         nlohmann::json root;
         root["version"] = PROJECT_VERSION;
@@ -80,6 +82,7 @@ namespace api::v1 {
             stats["users"] = userCount;
             root["stats"] = stats;
         }
+        root["deployments"] = deploymentStats;
 
         callback(jsonResponse(root));
     }
@@ -0,0 +1,99 @@
+#include "webhooks.h"
+
+#include <log/log.h>
+#include <nlohmann/json.hpp>
+#include <service/database/database.h>
+#include <service/storage/deployment_queue.h>
+#include <service/util.h>
+#include <service/util/crypto.h>
+
+#define SIGNATURE_HEADER "X-Hub-Signature-256"
+#define SIGNATURE_PREFIX "sha256="
+#define BRANCH_REF_PREFIX "refs/heads/"
+
+using namespace drogon;
+using namespace service;
+using namespace logging;
+
+// Projects may store their repository URL with or without the .git suffix or a trailing slash
+std::vector<std::string> getRepositoryUrlCandidates(const nlohmann::json &repository) {
+    std::vector<std::string> candidates;
+    for (const auto &key: {"clone_url", "html_url", "url"}) {
+        if (!repository.contains(key) || !repository[key].is_string()) {
+            continue;
+        }
+
+        std::string url = repository[key];
+        while (url.ends_with('/')) {
+            url.pop_back();
+        }
+        if (url.ends_with(".git")) {
+            url.resize(url.size() - 4);
+        }
+        if (url.empty()) {
+            continue;
+        }
+
+        for (const auto &candidate: {url, url + "/", url + ".git"}) {
+            if (std::ranges::find(candidates, candidate) == candidates.end()) {
+                candidates.push_back(candidate);
+            }
+        }
+    }
+    return candidates;
+}
+
+namespace api::v1 {
+    WebhookController::WebhookController(const std::string &secret) : secret_(secret) {}
+
+    Task<> WebhookController::push(const HttpRequestPtr req, const std::function<void(const HttpResponsePtr &)> callback) const {
+        if (secret_.empty()) {
+            throw ApiException(Error::ErrNotFound, "not_found");
+        }
+
+        const auto signature = req->getHeader(SIGNATURE_HEADER);
+        if (signature.empty()) {
+            throw ApiException(Error::ErrUnauthorized, "missing_signature");
+        }
+        const auto body = std::string(req->body());
+        if (const auto expected = SIGNATURE_PREFIX + crypto::hmacSha256Hex(body, secret_); !crypto::constantTimeEquals(signature, expected))
+        {
+            throw ApiException(Error::ErrForbidden, "invalid_signature");
+        }
+
+        const auto json = nlohmann::json::parse(body, nullptr, false);
+        if (json.is_discarded() || !json.is_object()) {
+            throw ApiException(Error::ErrBadRequest, "invalid_payload");
+        }
+
+        // Tag pushes and branch deletions do not affect deployed content
+        const std::string ref = json.contains("ref") && json["ref"].is_string() ? json["ref"].get<std::string>() : "";
+        if (!ref.starts_with(BRANCH_REF_PREFIX) || (json.contains("deleted") && json["deleted"].is_boolean() && json["deleted"])) {
+            callback(statusResponse(k204NoContent));
+            co_return;
+        }
+        const auto branch = ref.substr(std::string(BRANCH_REF_PREFIX).size());
+
+        if (!json.contains("repository") || !json["repository"].is_object()) {
+            throw ApiException(Error::ErrBadRequest, "invalid_payload");
+        }
+        const auto candidates = getRepositoryUrlCandidates(json["repository"]);
+        if (candidates.empty()) {
+            throw ApiException(Error::ErrBadRequest, "invalid_payload");
+        }
+
+        nlohmann::json deployed(nlohmann::json::value_t::array);
+        for (const auto projects = co_await global::database->getProjectsForRepo(candidates, branch); const auto &project: projects) {
+            logger.debug("Received push to branch '{}' of project '{}'", branch, project.getValueOfId());
+
+            if (const auto result = co_await global::deployments->enqueuePush(project); !result) {
+                throw ApiException(Error::ErrInternal, "internal");
+            }
+            deployed.push_back(project.getValueOfId());
+        }
+
+        auto resp = jsonResponse(nlohmann::json{{"projects", deployed}});
+        resp->setStatusCode(k202Accepted);
+        callback(resp);
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+
+namespace api::v1 {
+    // Receives signed repository push events and redeploys the projects tracking the pushed branch
+    class WebhookController final : public drogon::HttpController<WebhookController, false> {
+    public:
+        explicit WebhookController(const std::string &secret);
+
+        METHOD_LIST_BEGIN
+        ADD_METHOD_TO(WebhookController::push, "/api/v1/webhooks/push", drogon::Post);
+        METHOD_LIST_END
+
+        drogon::Task<> push(drogon::HttpRequestPtr req, std::function<void(const drogon::HttpResponsePtr &)> callback) const;
+
+    private:
+        std::string secret_;
+    };
+}
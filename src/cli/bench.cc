@@ -0,0 +1,256 @@
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <git2/global.h>
+#include <iostream>
+#include <log/log.h>
+#include <service/parallel.h>
+#include <service/storage/blobs.h>
+#include <service/storage/bundle.h>
+#include <service/storage/deployment.h>
+#include <service/util.h>
+#include <sstream>
+
+// Micro benchmarks of service internals that are too small to show up in wiki_ingest timings.
+// Each command times its operations over several iterations and reports the median, see test/bench for the scripts
+// generating their inputs.
+//
+//   json <file>...   Converting payloads between the JSON libraries, structurally and through a string round trip
+//   copy <dir>...    Copying docs trees into version directories, with new blobs and with blobs stored by an earlier version
+//   bundle <dir>...  Looking up and reading every file of a version directory from its bundle and from the directory layout
+
+#define USAGE "Usage: wiki_bench <command> [--iterations <n>] [--json] <args>...\nCommands: json <file>..., copy <dir>..., bundle <dir>..."
+
+using namespace logging;
+using namespace service;
+namespace fs = std::filesystem;
+
+struct BenchOptions {
+    std::string command;
+    std::vector<std::string> args;
+    int iterations = 10;
+    bool json = false;
+};
+
+struct BenchResult {
+    std::string name;
+    std::string operation;
+    int64_t median_us;
+    int64_t min_us;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(BenchResult, name, operation, median_us, min_us)
+};
+
+std::optional<BenchOptions> parseOptions(const int argc, char *argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            options.iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg.starts_with("--")) {
+            logger.error("Unexpected argument '{}'", arg);
+            return std::nullopt;
+        } else if (options.command.empty()) {
+            options.command = arg;
+        } else {
+            options.args.push_back(arg);
+        }
+    }
+
+    if (options.command.empty() || options.args.empty()) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+// Runs the operation once to warm up caches, then times every iteration
+BenchResult measure(const BenchOptions &options, const std::string &name, const std::string &operation, const std::function<void()> &func) {
+    func();
+
+    std::vector<int64_t> durations;
+    for (int i = 0; i < options.iterations; i++) {
+        const auto started = std::chrono::steady_clock::now();
+        func();
+        durations.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count());
+    }
+    std::ranges::sort(durations);
+
+    logger.info("{:<32} {:<24} {:>12} {:>12}", name, operation, durations[durations.size() / 2], durations.front());
+    return {.name = name, .operation = operation, .median_us = durations[durations.size() / 2], .min_us = durations.front()};
+}
+
+std::optional<std::vector<BenchResult>> benchJsonConversion(const BenchOptions &options) {
+    std::vector<BenchResult> results;
+    for (const auto &file: options.args) {
+        const auto payload = parseJsonFile(file);
+        if (!payload) {
+            logger.error("Failed to read JSON payload from {}", file);
+            return std::nullopt;
+        }
+        const auto name = fs::path(file).filename().string();
+        const auto converted = unparkourJson(*payload);
+
+        // Conversions used to serialize the value and parse it back with the other library
+        results.push_back(measure(options, name, "to jsoncpp (string)", [&] {
+            const auto value = parseJsonString(payload->dump());
+            if (!value) {
+                throw std::runtime_error("Failed to convert JSON");
+            }
+        }));
+        results.push_back(measure(options, name, "to jsoncpp", [&] { unparkourJson(*payload); }));
+        results.push_back(measure(options, name, "to nlohmann (string)",
+                                  [&] { static_cast<void>(nlohmann::json::parse(serializeJsonString(converted))); }));
+        results.push_back(measure(options, name, "to nlohmann", [&] { parkourJson(converted); }));
+    }
+    return results;
+}
+
+std::optional<std::vector<BenchResult>> benchCopyProjectFiles(const BenchOptions &options) {
+    const auto workDir =
+        fs::temp_directory_path() / std::format("wiki_bench_copy_{}", std::chrono::system_clock::now().time_since_epoch().count());
+    // Per file progress would dominate the measurement
+    const auto projectLog = std::make_shared<spdlog::logger>("copy", logger.sinks().begin(), logger.sinks().end());
+    projectLog->set_level(spdlog::level::warn);
+
+    std::vector<BenchResult> results;
+    size_t versions = 0;
+    const auto copy = [&](const fs::path &docsRoot, const BlobStore &blobs) {
+        CopyCounters counters;
+        if (copyProjectFiles(docsRoot, workDir / "versions" / std::to_string(versions++), blobs, counters, projectLog) != Error::Ok) {
+            throw std::runtime_error("Failed to copy files");
+        }
+    };
+
+    try {
+        for (const auto &dir: options.args) {
+            const auto name = fs::path(dir).filename().string();
+
+            // Every copy of the first version writes its files into an empty blob store
+            size_t stores = 0;
+            results.push_back(measure(options, name, "copy (new blobs)", [&] {
+                const BlobStore blobs{workDir / "blobs" / std::to_string(stores++)};
+                copy(dir, blobs);
+            }));
+
+            // Later versions and deployments mostly link files that are already stored
+            const BlobStore shared{workDir / "blobs" / "shared"};
+            results.push_back(measure(options, name, "copy (stored blobs)", [&] { copy(dir, shared); }));
+
+            remove_all(workDir);
+        }
+    } catch (const std::exception &e) {
+        logger.error("Failed to copy {}: {}", workDir.string(), e.what());
+        std::error_code ec;
+        remove_all(workDir, ec);
+        return std::nullopt;
+    }
+    return results;
+}
+
+std::optional<std::vector<BenchResult>> benchBundleReads(const BenchOptions &options) {
+    std::vector<BenchResult> results;
+    for (const auto &dir: options.args) {
+        const auto root = fs::path(dir);
+        const auto name = root.filename().string();
+
+        std::vector<std::string> keys;
+        for (const auto &entry: fs::recursive_directory_iterator(root)) {
+            if (entry.is_regular_file()) {
+                keys.push_back(entry.path().lexically_relative(root).generic_string());
+            }
+        }
+
+        const auto file = fs::temp_directory_path() / std::format("wiki_bench_{}.bundle", name);
+        if (DeploymentBundle::write(root, file) != Error::Ok) {
+            logger.error("Failed to write bundle of {}", dir);
+            return std::nullopt;
+        }
+        const auto bundle = DeploymentBundle::open(file);
+        remove(file);
+        if (!bundle) {
+            logger.error("Failed to open bundle of {}", dir);
+            return std::nullopt;
+        }
+        logger.info("Bundled {} files of {}", keys.size(), dir);
+
+        // Mirrors how resolved projects check and read files with and without a bundle
+        results.push_back(measure(options, name, "exists (files)", [&] {
+            for (const auto &key: keys) {
+                if (!exists(root / key)) {
+                    throw std::runtime_error("Missing file " + key);
+                }
+            }
+        }));
+        results.push_back(measure(options, name, "exists (bundle)", [&] {
+            for (const auto &key: keys) {
+                if (!bundle->contains(key)) {
+                    throw std::runtime_error("Missing bundle entry " + key);
+                }
+            }
+        }));
+        results.push_back(measure(options, name, "read (files)", [&] {
+            for (const auto &key: keys) {
+                std::ifstream stream(root / key);
+                std::stringstream buffer;
+                buffer << stream.rdbuf();
+                static_cast<void>(buffer.str());
+            }
+        }));
+        results.push_back(measure(options, name, "read (bundle)", [&] {
+            for (const auto &key: keys) {
+                if (const auto content = bundle->read(key)) {
+                    static_cast<void>(std::string{*content});
+                } else {
+                    throw std::runtime_error("Missing bundle entry " + key);
+                }
+            }
+        }));
+    }
+    return results;
+}
+
+int main(const int argc, char *argv[]) {
+    const auto options = parseOptions(argc, argv);
+    if (!options) {
+        logger.error(USAGE);
+        return 1;
+    }
+
+    static const std::unordered_map<std::string, std::function<std::optional<std::vector<BenchResult>>(const BenchOptions &)>> commands{
+        {"json", benchJsonConversion}, {"copy", benchCopyProjectFiles}, {"bundle", benchBundleReads}};
+
+    const auto command = commands.find(options->command);
+    if (command == commands.end()) {
+        logger.error("Unknown command '{}'\n{}", options->command, USAGE);
+        return 1;
+    }
+
+    deploymentThreadPool.start();
+    git_libgit2_init();
+
+    int exitCode = 0;
+    try {
+        logger.info("{:<32} {:<24} {:>12} {:>12}", "Input", "Operation", "median (us)", "min (us)");
+        if (const auto results = command->second(*options); !results) {
+            exitCode = 1;
+        } else if (options->json) {
+            std::cout << nlohmann::json{{"command", options->command}, {"iterations", options->iterations}, {"results", *results}}.dump(2)
+                      << std::endl;
+        }
+    } catch (const std::exception &e) {
+        logger.critical("Error running benchmark: {}", e.what());
+        exitCode = 1;
+    }
+
+    git_libgit2_shutdown();
+    for (auto &loop: deploymentThreadPool.getLoops()) {
+        loop->quit();
+    }
+    deploymentThreadPool.wait();
+
+    return exitCode;
+}
@@ -0,0 +1,348 @@
+#include <drogon/drogon.h>
+#include <iostream>
+#include <ranges>
+#include <log/log.h>
+#include <schemas/schemas.h>
+#include <service/cache.h>
+#include <service/database/database.h>
+#include <service/database/project_database.h>
+#include <service/file_io.h>
+#include <service/parallel.h>
+#include <service/project/resolved.h>
+#include <service/project/virtual/virtual.h>
+#include <service/storage/deployment.h>
+#include <service/storage/ingestor/ingestor.h>
+#include <service/storage/ingestor/recipe/recipe_builtin.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+// Runs the content stages of a deployment against a local wiki directory, so that ingest performance can be profiled
+// and regressions bisected without deploying real projects.
+//
+// A dry run only parses and validates the project files. Otherwise, content is ingested into a staging version of an
+// existing project in the database configured through the DB_* environment variables. The staging version is never
+// activated and is deleted after each run, so repeated runs measure the same work.
+//
+// Staging versions, their partitions and interned item and tag locations are still written to that database, and
+// creating partitions briefly locks the content tables. Point it at a development copy, never at a live database.
+
+#define USAGE "Usage: wiki_ingest <docs root> --project <id> [--modid <modid>] [--dry-run] [--runs <n>] [--modules <names>] [--json]"
+
+// Game files are never read while ingesting, only the virtual project's version is
+#define GAME_FILES_PATH ".game"
+
+static const std::vector<std::string> DATABASE_VARIABLES{"DB_HOST", "DB_PORT", "DB_DATABASE", "DB_USER", "DB_PASSWORD"};
+
+using namespace drogon;
+using namespace logging;
+using namespace service;
+namespace fs = std::filesystem;
+
+struct IngestOptions {
+    fs::path root;
+    std::string project;
+    std::string modid;
+    bool dryRun = false;
+    int runs = 1;
+    std::set<std::string> modules;
+    bool json = false;
+};
+
+struct DirectorySize {
+    int64_t files = 0;
+    int64_t bytes = 0;
+};
+
+std::optional<IngestOptions> parseOptions(const int argc, char *argv[]) {
+    static const std::unordered_map<std::string, std::string> moduleNames{{"content_paths", INGESTOR_CONTENT_PATHS},
+                                                                           {"tags", INGESTOR_TAGS},
+                                                                           {"recipes", INGESTOR_RECIPES},
+                                                                           {"metadata", INGESTOR_METADATA}};
+
+    IngestOptions options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const auto hasValue = i + 1 < argc;
+
+        if (arg == "--dry-run") {
+            options.dryRun = true;
+        } else if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--project" && hasValue) {
+            options.project = argv[++i];
+        } else if (arg == "--modid" && hasValue) {
+            options.modid = argv[++i];
+        } else if (arg == "--runs" && hasValue) {
+            options.runs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--modules" && hasValue) {
+            for (const auto name: std::views::split(std::string_view(argv[++i]), ',')) {
+                const auto module = moduleNames.find(std::string(name.begin(), name.end()));
+                if (module == moduleNames.end()) {
+                    logger.error("Unknown ingestor module '{}'", std::string(name.begin(), name.end()));
+                    return std::nullopt;
+                }
+                options.modules.insert(module->second);
+            }
+        } else if (!arg.starts_with("--") && options.root.empty()) {
+            options.root = arg;
+        } else {
+            logger.error("Unexpected argument '{}'", arg);
+            return std::nullopt;
+        }
+    }
+
+    if (options.root.empty() || options.project.empty()) {
+        return std::nullopt;
+    }
+    if (!exists(options.root)) {
+        logger.error("Docs root {} does not exist", options.root.string());
+        return std::nullopt;
+    }
+    return options;
+}
+
+void configureDatabase() {
+    Json::Value db;
+    db["name"] = "default";
+    db["rdbms"] = "postgresql";
+    db["host"] = std::getenv("DB_HOST");
+    db["port"] = std::stoi(std::getenv("DB_PORT"));
+    db["dbname"] = std::getenv("DB_DATABASE");
+    db["user"] = std::getenv("DB_USER");
+    db["passwd"] = std::getenv("DB_PASSWORD");
+    db["is_fast"] = true;
+    db["connection_number"] = 1;
+    db["timeout"] = 60;
+
+    Json::Value root;
+    root["db_clients"] = Json::Value(Json::arrayValue);
+    root["db_clients"].append(db);
+    app().loadConfigJson(root);
+}
+
+DirectorySize getDirectorySize(const fs::path &root) {
+    DirectorySize size;
+    for (const auto &entry: fs::recursive_directory_iterator(root)) {
+        if (entry.is_regular_file()) {
+            size.files++;
+            size.bytes += static_cast<int64_t>(entry.file_size());
+        }
+    }
+    return size;
+}
+
+Task<TaskResult<Project>> loadProject(const IngestOptions &options) {
+    if (options.dryRun) {
+        Project project;
+        project.setId(options.project);
+        project.setModid(options.modid.empty() ? options.project : options.modid);
+        co_return project;
+    }
+
+    const auto project = co_await global::database->getProjectSource(options.project);
+    if (!project) {
+        logger.error("Project {} not found", options.project);
+        co_return Error::ErrNotFound;
+    }
+    co_return *project;
+}
+
+Task<TaskResult<DeploymentMetrics>> runOnce(const IngestOptions &options, const Project &project,
+                                            const std::shared_ptr<spdlog::logger> &projectLog) {
+    const auto started = std::chrono::steady_clock::now();
+    const auto startPeakMemoryKb = getPeakMemoryKb();
+    const auto issues = std::make_shared<ProjectIssueCallback>("", projectLog);
+    DeploymentMetrics metrics;
+
+    {
+        StageTimer timer{&metrics};
+        ResolvedProject resolved{project, options.root, ProjectVersion{}, issues, projectLog};
+
+        timer.begin("validate_metadata");
+        if (const auto [c, e, details] = resolved.validateProjectMetadata(); !details.empty()) {
+            projectLog->error("Invalid project metadata: {}", details);
+            co_return Error::ErrBadRequest;
+        }
+
+        timer.begin("validate_pages");
+        co_await resolved.validatePages();
+        timer.finish();
+
+        if (options.dryRun) {
+            content::Ingestor ingestor{resolved, projectLog, issues, options.modules, false};
+            ingestor.setMetrics(metrics);
+            if (const auto result = co_await ingestor.runPreparation(); result != Error::Ok) {
+                co_return result;
+            }
+        } else {
+            timer.begin("create_version");
+            const auto staging = co_await global::database->createStagingVersion(project.getValueOfId(), project.getValueOfSourceBranch());
+            if (!staging) {
+                projectLog->error("Staging version creation database error.");
+                co_return staging.error();
+            }
+            timer.finish();
+
+            ResolvedProject staged{project, options.root, *staging, issues, projectLog};
+            content::Ingestor ingestor{staged, projectLog, issues, options.modules, false};
+            ingestor.setMetrics(metrics);
+            const auto result = co_await ingestor.runIngestor();
+            metrics.rows_inserted = co_await staged.getProjectDatabase().getIngestedRowCount();
+
+            timer.begin("delete_version");
+            if (const auto deleted = co_await global::database->deleteStagingVersion(project.getValueOfId(), staging->getValueOfId());
+                !deleted) {
+                projectLog->warn("Failed to delete staging version {}", staging->getValueOfId());
+            }
+            if (result != Error::Ok) {
+                co_return result;
+            }
+        }
+    }
+
+    if (issues->hasErrors()) {
+        projectLog->warn("Encountered errors in project files, timings may not be representative");
+    }
+
+    metrics.total_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    metrics.process_peak_memory_kb = getPeakMemoryKb();
+    metrics.peak_memory_growth_kb = metrics.process_peak_memory_kb - startPeakMemoryKb;
+    co_return metrics;
+}
+
+void printReport(const IngestOptions &options, const DirectorySize &size, const std::vector<DeploymentMetrics> &runs) {
+    // Stages keep the order they were first recorded in
+    std::vector<std::pair<std::string, std::vector<int64_t>>> stages;
+    std::vector<int64_t> totals;
+    std::vector<int64_t> rows;
+    for (const auto &run: runs) {
+        for (const auto &[name, duration]: run.stages) {
+            auto stage = std::ranges::find(stages, name, &std::pair<std::string, std::vector<int64_t>>::first);
+            if (stage == stages.end()) {
+                stages.emplace_back(name, std::vector<int64_t>{});
+                stage = std::prev(stages.end());
+            }
+            stage->second.push_back(duration);
+        }
+        totals.push_back(run.total_ms);
+        rows.push_back(run.rows_inserted.value_or(0));
+    }
+
+    const auto median = [](std::vector<int64_t> values) {
+        std::ranges::sort(values);
+        return values[values.size() / 2];
+    };
+
+    logger.info("{:<32} {:>10} {:>10} {:>10}", "Stage (ms)", "min", "median", "max");
+    for (const auto &[name, durations]: stages) {
+        const auto [min, max] = std::ranges::minmax(durations);
+        logger.info("{:<32} {:>10} {:>10} {:>10}", name, min, median(durations), max);
+    }
+    const auto [minTotal, maxTotal] = std::ranges::minmax(totals);
+    const auto medianTotal = median(totals);
+    logger.info("{:<32} {:>10} {:>10} {:>10}", "total", minTotal, medianTotal, maxTotal);
+
+    const auto seconds = std::max<double>(static_cast<double>(medianTotal) / 1000.0, 0.001);
+    logger.info("Read {} files ({:.2f} MB) at {:.1f} files/s, {:.2f} MB/s", size.files, static_cast<double>(size.bytes) / 1e6,
+                static_cast<double>(size.files) / seconds, static_cast<double>(size.bytes) / 1e6 / seconds);
+    if (!options.dryRun) {
+        const auto inserted = median(rows);
+        logger.info("Inserted {} rows at {:.1f} rows/s", inserted, static_cast<double>(inserted) / seconds);
+    }
+    logger.info("Peak memory usage {} KB, the first run raised it by {} KB", runs.back().process_peak_memory_kb,
+                runs.front().peak_memory_growth_kb);
+
+    if (options.json) {
+        std::cout << nlohmann::json{{"dry_run", options.dryRun}, {"files", size.files}, {"bytes", size.bytes}, {"runs", runs}}.dump(2)
+                  << std::endl;
+    }
+}
+
+Task<int> runBenchmark(const IngestOptions options) {
+    try {
+        if (!options.dryRun) {
+            global::database = std::make_shared<Database>();
+            global::virtualProject = co_await createVirtualProject(GAME_FILES_PATH);
+        }
+
+        const auto project = co_await loadProject(options);
+        if (!project) {
+            co_return 1;
+        }
+
+        const auto projectLog = spdlog::stdout_color_mt(options.project);
+        projectLog->set_pattern("[%^%L%$] [%T %z] [thread %t] [%n] %v");
+
+        const auto size = getDirectorySize(options.root);
+        logger.info("Ingesting {} files from {}{}", size.files, options.root.string(), options.dryRun ? " (dry run)" : "");
+
+        std::vector<DeploymentMetrics> runs;
+        for (int i = 0; i < options.runs; i++) {
+            logger.info("Starting run {}/{}", i + 1, options.runs);
+
+            const auto metrics = co_await runOnce(options, *project, projectLog);
+            if (!metrics) {
+                logger.error("Run {} failed", i + 1);
+                co_return 1;
+            }
+            runs.push_back(*metrics);
+        }
+
+        printReport(options, size, runs);
+        co_return 0;
+    } catch (const std::exception &e) {
+        logger.critical("Error running ingest: {}", e.what());
+        co_return 1;
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    const auto options = parseOptions(argc, argv);
+    if (!options) {
+        logger.error(USAGE);
+        return 1;
+    }
+
+    if (!options->dryRun) {
+        const auto missing = std::ranges::find_if(DATABASE_VARIABLES, [](const std::string &name) { return !std::getenv(name.c_str()); });
+        if (missing != DATABASE_VARIABLES.end()) {
+            logger.error("Database environment variable {} is not set, use --dry-run to ingest without a database", *missing);
+            return 1;
+        }
+        try {
+            configureDatabase();
+        } catch (const std::exception &) {
+            logger.error("Invalid database port '{}'", std::getenv("DB_PORT"));
+            return 1;
+        }
+    }
+
+    cacheAwaiterThreadPool.start();
+    fileIOThreadPool.start();
+    deploymentThreadPool.start();
+
+    content::loadBuiltinRecipeTypes();
+    compileJsonValidators(schemas::getAll());
+
+    int exitCode = 0;
+    app().getLoop()->queueInLoop(async_func([&]() -> Task<> {
+        exitCode = co_await runBenchmark(*options);
+        app().quit();
+    }));
+
+    app().run();
+
+    for (auto &loop: cacheAwaiterThreadPool.getLoops()) {
+        loop->quit();
+    }
+    cacheAwaiterThreadPool.wait();
+    for (auto &loop: fileIOThreadPool.getLoops()) {
+        loop->quit();
+    }
+    fileIOThreadPool.wait();
+    for (auto &loop: deploymentThreadPool.getLoops()) {
+        loop->quit();
+    }
+    deploymentThreadPool.wait();
+
+    return exitCode;
+}
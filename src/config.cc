@@ -9,6 +9,9 @@ using namespace drogon;
 using namespace logging;
 using namespace config;
 
+#define DEFAULT_DEPLOYMENT_WORKERS 2
+#define DEFAULT_MIRROR_CACHE_MB 4096
+
 void configureAppFromEnvironment() {
     Json::Value root;
     {
@@ -74,6 +77,10 @@ SystemConfig configureFromEnvironment() {
     Modrinth modrinth = {.clientId = std::getenv("MODRINTH_CLIENT_ID"), .clientSecret = std::getenv("MODRINTH_CLIENT_SECRET")};
     Crowdin crowdin = {.token = std::getenv("CROWDIN_TOKEN"), .projectId = std::getenv("CROWDIN_PROJECT_ID")};
     Sentry sentry = {.dsn = std::getenv("SENTRY_DSN")};
+    const auto deploymentWorkers = std::getenv("DEPLOYMENT_WORKERS");
+    const auto deploymentBundles = std::getenv("DEPLOYMENT_BUNDLES");
+    const auto mirrorCacheMb = std::getenv("MIRROR_CACHE_MB");
+    const auto webhookSecret = std::getenv("WEBHOOK_SECRET");
     return {.auth = auth,
             .githubApp = githubApp,
             .modrinth = modrinth,
@@ -84,7 +91,11 @@ SystemConfig configureFromEnvironment() {
             .curseForgeKey = std::getenv("CURSEFORGE_KEY"),
             .storagePath = std::getenv("STORAGE_PATH"),
             .salt = std::getenv("SALT"),
-            .local = std::string(std::getenv("LOCAL")) == "true"};
+            .local = std::string(std::getenv("LOCAL")) == "true",
+            .deploymentWorkers = deploymentWorkers ? std::stoul(deploymentWorkers) : DEFAULT_DEPLOYMENT_WORKERS,
+            .deploymentBundles = deploymentBundles && std::string(deploymentBundles) == "true",
+            .mirrorCacheMb = mirrorCacheMb ? std::stoul(mirrorCacheMb) : DEFAULT_MIRROR_CACHE_MB,
+            .webhookSecret = webhookSecret ? webhookSecret : ""};
 }
 
 SystemConfig config::configure() {
@@ -130,7 +141,14 @@ SystemConfig config::configure() {
                            .curseForgeKey = customConfig["curseforge_key"].asString(),
                            .storagePath = customConfig["storage_path"].asString(),
                            .salt = customConfig["salt"].asString(),
-                           .local = customConfig.isMember("local") && customConfig["local"].asBool()};
+                           .local = customConfig.isMember("local") && customConfig["local"].asBool(),
+                           .deploymentWorkers = customConfig.isMember("deployment_workers")
+                                                    ? customConfig["deployment_workers"].asUInt()
+                                                    : DEFAULT_DEPLOYMENT_WORKERS,
+                           .deploymentBundles = customConfig.isMember("deployment_bundles") && customConfig["deployment_bundles"].asBool(),
+                           .mirrorCacheMb = customConfig.isMember("mirror_cache_mb") ? customConfig["mirror_cache_mb"].asUInt()
+                                                                                     : DEFAULT_MIRROR_CACHE_MB,
+                           .webhookSecret = customConfig["webhook_secret"].asString()};
 
     if (!customConfig.isMember("api_key") || customConfig["api_key"].asString().empty()) {
         logger.warn("No API key configured, allowing public API access.");
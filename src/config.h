@@ -43,6 +43,10 @@ namespace config {
         std::string storagePath;
         std::string salt;
         bool local;
+        size_t deploymentWorkers;
+        bool deploymentBundles;
+        size_t mirrorCacheMb;
+        std::string webhookSecret;
     };
 
     SystemConfig configure();
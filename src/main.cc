@@ -12,15 +12,20 @@
 #include <api/v1/projects/docs.h>
 #include <api/v1/projects/game.h>
 #include <api/v1/system.h>
+#include <api/v1/webhooks.h>
 #include <git2.h>
 #include <log/log.h>
+#include <schemas/schemas.h>
 
 #include <service/database/database.h>
 #include <service/external/crowdin.h>
+#include <service/file_io.h>
+#include <service/parallel.h>
 #include <service/external/frontend.h>
 #include <service/external/github.h>
 #include <service/project/virtual/virtual.h>
 #include <service/storage/ingestor/recipe/recipe_builtin.h>
+#include <service/storage/deployment_queue.h>
 #include <service/storage/realtime.h>
 #include <service/storage/issues/issue_service.h>
 #include <service/system/access_keys.h>
@@ -33,27 +38,6 @@ using namespace logging;
 using namespace service;
 namespace fs = std::filesystem;
 
-namespace service {
-    trantor::EventLoopThreadPool cacheAwaiterThreadPool{10};
-}
-
-namespace global {
-    std::shared_ptr<Database> database;
-    std::shared_ptr<MemoryCache> cache;
-    std::shared_ptr<GitHub> github;
-    std::shared_ptr<realtime::ConnectionManager> connections;
-    std::shared_ptr<Storage> storage;
-    std::shared_ptr<IssueService> issues;
-    std::shared_ptr<Auth> auth;
-    std::shared_ptr<LangService> lang;
-    std::shared_ptr<GameDataService> gameData;
-    std::shared_ptr<Crowdin> crowdin;
-    std::shared_ptr<AccessKeys> accessKeys;
-    std::shared_ptr<FrontendService> frontend;
-    std::shared_ptr<Platforms> platforms;
-    std::shared_ptr<VirtualProject> virtualProject;
-}
-
 void globalExceptionHandler(const std::exception &e, const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) {
     if (const auto cast = dynamic_cast<const ApiException *>(&e); cast != nullptr) {
         const auto resp = HttpResponse::newHttpJsonResponse(std::move(cast->data));
@@ -72,6 +56,8 @@ Task<> runStartupTaks(const bool isLocal, const fs::path gameFilesPath) {
     global::virtualProject = co_await createVirtualProject(gameFilesPath);
 
     co_await cleanupLoadingDeployments();
+    scheduleVersionVacuum();
+    co_await global::deployments->restore();
     if (!isLocal) {
         co_await global::gameData->importGameData(false);
         co_await global::crowdin->getAvailableLocales();
@@ -87,8 +73,8 @@ int main() {
         app().setLogLevel(level).addListener("0.0.0.0", port).setThreadNum(16);
         configureLoggingLevel();
 
-        const auto [authConfig, githubAppConfig, mrApp, crowdinConfig, sentryConfig, appUrl, curseForgeKey, storagePath, salt, local] =
-            config::configure();
+        const auto [authConfig, githubAppConfig, mrApp, crowdinConfig, sentryConfig, appUrl, curseForgeKey, storagePath, salt, local,
+                    deploymentWorkers, deploymentBundles, mirrorCacheMb, webhookSecret] = config::configure();
 
         if (!sentryConfig.dsn.empty()) {
             monitor::initSentry(sentryConfig.dsn);
@@ -101,7 +87,8 @@ int main() {
         global::cache = std::make_shared<MemoryCache>();
         global::github = std::make_shared<GitHub>();
         global::connections = std::make_shared<realtime::ConnectionManager>();
-        global::storage = std::make_shared<Storage>(storagePath);
+        global::storage = std::make_shared<Storage>(storagePath, deploymentBundles, mirrorCacheMb * 1024 * 1024);
+        global::deployments = std::make_shared<DeploymentQueue>(deploymentWorkers);
         global::issues = std::make_shared<IssueService>();
         global::auth = std::make_shared<Auth>(appUrl, OAuthApp{githubAppConfig.clientId, githubAppConfig.clientSecret},
                                               OAuthApp{mrApp.clientId, mrApp.clientSecret});
@@ -122,6 +109,7 @@ int main() {
         auto gameController(std::make_shared<api::v1::GameController>());
         auto systemController(std::make_shared<api::v1::SystemController>());
         auto moderationController(std::make_shared<api::v1::ModerationController>());
+        auto webhookController(std::make_shared<api::v1::WebhookController>(webhookSecret));
 
         app().registerController(authController);
         app().registerController(controller);
@@ -131,14 +119,19 @@ int main() {
         app().registerController(gameController);
         app().registerController(systemController);
         app().registerController(moderationController);
+        app().registerController(webhookController);
         app().setExceptionHandler(globalExceptionHandler);
         app().setIdleConnectionTimeout(180);
         setupCors();
 
         cacheAwaiterThreadPool.start();
+        fileIOThreadPool.start();
+        deploymentThreadPool.start();
+        global::deployments->start();
         git_libgit2_init();
 
         content::loadBuiltinRecipeTypes();
+        compileJsonValidators(schemas::getAll());
 
         app().getLoop()->queueInLoop(async_func([=]() -> Task<> { co_await runStartupTaks(local, gameFilesPath); }));
 
@@ -149,6 +142,15 @@ int main() {
             loop->quit();
         }
         cacheAwaiterThreadPool.wait();
+        for (auto &loop: fileIOThreadPool.getLoops()) {
+            loop->quit();
+        }
+        fileIOThreadPool.wait();
+        for (auto &loop: deploymentThreadPool.getLoops()) {
+            loop->quit();
+        }
+        deploymentThreadPool.wait();
+        global::deployments->stop();
     } catch (const std::exception &e) {
         logger.critical("Error running app: {}", e.what());
     }
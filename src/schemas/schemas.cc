@@ -161,3 +161,10 @@ nlohmann::json schemas::gameRecipeCustom = R"(@CUSTOM_GAME_RECIPE_SCHEMA@)"_json
 nlohmann::json schemas::recipeWorkbenches = R"(@RECIPE_WORKBENCHES@)"_json;
 
 nlohmann::json schemas::properties = R"(@PROPERTIES@)"_json;
+
+std::vector<const nlohmann::json *> schemas::getAll() {
+    return {&getBulkProjects, &systemConfig, &projectRegister, &projectUpdateSource, &projectUpdate,
+            &projectMetadata, &folderMetadata, &projectIssue, &report, &ruleReport,
+            &accessKey, &addProjectMember, &removeProjectMember,
+            &gameRecipe, &gameRecipeType, &gameRecipeBase, &gameRecipeCustom, &gameTag, &recipeWorkbenches, &properties};
+}
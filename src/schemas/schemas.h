@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nlohmann/json_fwd.hpp>
+#include <vector>
 
 namespace schemas {
     extern nlohmann::json getBulkProjects;
@@ -26,4 +27,6 @@ namespace schemas {
     extern nlohmann::json gameTag;
     extern nlohmann::json recipeWorkbenches;
     extern nlohmann::json properties;
+
+    std::vector<const nlohmann::json *> getAll();
 }
@@ -109,10 +109,15 @@ namespace service {
     }
 
     Task<TaskResult<>> Database::removeProject(const std::string &id) const {
-        co_return co_await handleDatabaseOperation([id](const DbClientPtr &client) -> Task<> {
-            CoroMapper<Project> mapper(client);
-            co_await mapper.deleteByPrimaryKey(id);
-        });
+        // Versions outlive the project until deleteRetiredVersions drops their content partitions
+        // language=postgresql
+        static constexpr auto query = "WITH retired AS ( \
+                                           UPDATE project_version SET live = false, retired_at = CURRENT_TIMESTAMP \
+                                           WHERE project_id = $1 AND retired_at IS NULL \
+                                       ) \
+                                       DELETE FROM project WHERE id = $1";
+
+        co_return co_await handleDatabaseOperation([id](const DbClientPtr &client) -> Task<> { co_await client->execSqlCoro(query, id); });
     }
 
     Task<TaskResult<ProjectVersion>> Database::createProjectVersion(ProjectVersion version) const {
@@ -129,7 +134,8 @@ namespace service {
 
     Task<TaskResult<ProjectVersion>> Database::getDefaultProjectVersion(std::string project) const {
         co_return co_await findOne<ProjectVersion>(Criteria(ProjectVersion::Cols::_project_id, CompareOperator::EQ, project) &&
-                                                   Criteria(ProjectVersion::Cols::_name, CompareOperator::IsNull));
+                                                   Criteria(ProjectVersion::Cols::_name, CompareOperator::IsNull) &&
+                                                   Criteria("live", CompareOperator::EQ, true));
     }
 
     Task<TaskResult<>> Database::deleteProjectVersions(std::string project) const {
@@ -139,6 +145,99 @@ namespace service {
         });
     }
 
+    Task<TaskResult<ProjectVersion>> Database::createStagingVersion(const std::string project, const std::string branch,
+                                                                    const std::optional<std::string> deploymentId) const {
+        // Staging versions left behind by failed deployments are retired along the way,
+        // those of deployments that are still running are left alone until they finish
+        // language=postgresql
+        static constexpr auto query = "WITH retired AS ( \
+                                           UPDATE project_version SET retired_at = CURRENT_TIMESTAMP \
+                                           WHERE project_id = $1 AND name IS NULL AND NOT live AND retired_at IS NULL \
+                                           AND NOT EXISTS (SELECT 1 FROM deployment \
+                                                           WHERE deployment.id = project_version.deployment_id \
+                                                           AND deployment.status IN ('created', 'loading')) \
+                                       ) \
+                                       INSERT INTO project_version (project_id, branch, live, deployment_id) VALUES ($1, $2, false, $3) \
+                                       RETURNING *";
+        // Staged content gets partitions of its own, so that it can be dropped as a whole once retired
+        // language=postgresql
+        static constexpr auto partitionQuery = "SELECT create_version_partitions($1)";
+
+        co_return co_await handleDatabaseOperation([&](const DbClientPtr &client) -> Task<ProjectVersion> {
+            const auto results = co_await client->execSqlCoro(query, project, branch, deploymentId);
+            if (results.size() != 1) {
+                throw DrogonDbException{};
+            }
+            const ProjectVersion version(results.front());
+            co_await client->execSqlCoro(partitionQuery, version.getValueOfId());
+            co_return version;
+        });
+    }
+
+    Task<TaskResult<>> Database::activateStagingVersion(const std::string project, const int64_t versionId) const {
+        // Run as separate statements, as the live index is checked for every updated row
+        // language=postgresql
+        static constexpr auto retireQuery = "UPDATE project_version SET live = false, retired_at = CURRENT_TIMESTAMP \
+                                             WHERE project_id = $1 AND name IS NULL AND live";
+        // language=postgresql
+        static constexpr auto activateQuery = "UPDATE project_version SET live = true \
+                                               WHERE id = $2 AND project_id = $1 AND name IS NULL AND retired_at IS NULL";
+
+        co_return co_await handleDatabaseOperation([&](const DbClientPtr &client) -> Task<> {
+            co_await client->execSqlCoro(retireQuery, project);
+            if (const auto results = co_await client->execSqlCoro(activateQuery, project, versionId); results.affectedRows() != 1) {
+                throw DrogonDbException{};
+            }
+        });
+    }
+
+    Task<TaskResult<>> Database::retireStagingVersions() const {
+        // language=postgresql
+        static constexpr auto query = "UPDATE project_version SET retired_at = CURRENT_TIMESTAMP \
+                                       WHERE name IS NULL AND NOT live AND retired_at IS NULL";
+
+        co_return co_await handleDatabaseOperation([](const DbClientPtr &client) -> Task<> { co_await client->execSqlCoro(query); });
+    }
+
+    // Discards a staging version right away, for ingests that are never meant to be activated
+    Task<TaskResult<>> Database::deleteStagingVersion(const std::string project, const int64_t versionId) const {
+        // language=postgresql
+        static constexpr auto query = "SELECT delete_project_version(id) FROM project_version \
+                                       WHERE id = $2 AND project_id = $1 AND name IS NULL AND NOT live";
+
+        co_return co_await handleDatabaseOperation([&](const DbClientPtr &client) -> Task<> {
+            if (const auto results = co_await client->execSqlCoro(query, project, versionId); results.size() != 1) {
+                throw DrogonDbException{};
+            }
+        });
+    }
+
+    Task<TaskResult<int64_t>> Database::deleteRetiredVersions(const std::chrono::seconds gracePeriod) const {
+        // language=postgresql
+        static constexpr auto query = "SELECT id FROM project_version \
+                                       WHERE retired_at < CURRENT_TIMESTAMP - make_interval(secs => $1)";
+        // Drops the version's partitions, remaining content is removed through cascading deletes
+        // language=postgresql
+        static constexpr auto deleteQuery = "SELECT delete_project_version($1)";
+
+        co_return co_await handleDatabaseOperation([gracePeriod](const DbClientPtr &client) -> Task<int64_t> {
+            const auto results = co_await client->execSqlCoro(query, static_cast<int64_t>(gracePeriod.count()));
+            // Versions are deleted one at a time to keep partition locks short. Deletions that time out waiting for
+            // their locks are retried by the next run.
+            int64_t deleted = 0;
+            for (const auto &row: results) {
+                const auto id = row[0].as<int64_t>();
+                try {
+                    co_await client->execSqlCoro(deleteQuery, id);
+                    deleted++;
+                } catch (const DrogonDbException &e) {
+                    logger.warn("Postponing deletion of project version {}: {}", id, e.base().what());
+                }
+            }
+            co_return deleted;
+        });
+    }
+
     Task<TaskResult<ProjectSearchResponse>> Database::findProjects(const std::string query, const std::string types, const std::string sort,
                                                                    int page) const {
         co_return co_await handleDatabaseOperation([query, types, sort, page](const DbClientPtr &client) -> Task<ProjectSearchResponse> {
@@ -232,6 +331,16 @@ namespace service {
         co_return res.value_or(false);
     }
 
+    Task<std::vector<Project>> Database::getProjectsForRepo(const std::vector<std::string> repos, const std::string branch) const {
+        const auto res = co_await handleDatabaseOperation([repos, branch](const DbClientPtr &client) -> Task<std::vector<Project>> {
+            CoroMapper<Project> mapper(client);
+            co_return co_await mapper.findBy(Criteria(Project::Cols::_source_repo, CompareOperator::In, repos) &&
+                                             Criteria(Project::Cols::_source_branch, CompareOperator::EQ, branch) &&
+                                             Criteria(Project::Cols::_is_virtual, CompareOperator::EQ, false));
+        });
+        co_return res.value_or({});
+    }
+
     Task<bool> Database::existsForData(const std::string id, const nlohmann::json platforms) const {
         const auto res = co_await handleDatabaseOperation([id, platforms](const DbClientPtr &client) -> Task<bool> {
             CoroMapper<Project> mapper(client);
@@ -336,7 +445,7 @@ namespace service {
         // language=postgresql
         static constexpr auto query = "SELECT pv.project_id FROM project_item pitem \
                                        JOIN project_version pv ON pv.id = pitem.version_id \
-                                       WHERE pitem.item_id = $1";
+                                       WHERE pitem.item_id = $1 AND pv.live";
 
         const auto res = co_await handleDatabaseOperation([item](const DbClientPtr &client) -> Task<std::vector<std::string>> {
             const auto results = co_await client->execSqlCoro(query, item);
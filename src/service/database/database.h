@@ -45,6 +45,7 @@ namespace service {
         std::string user_id;
         std::string created_at;
         bool active;
+        std::optional<nlohmann::json> metrics;
 
         friend void to_json(nlohmann::json &j, const DeploymentData &d) {
             j = nlohmann::json{{"id", d.id},
@@ -54,10 +55,35 @@ namespace service {
                                {"status", d.status},
                                {"user_id", emptyStrNullable(d.user_id)},
                                {"created_at", d.created_at},
-                               {"active", d.active}};
+                               {"active", d.active},
+                               {"metrics", d.metrics.value_or(nullptr)}};
         }
     };
 
+    struct ProjectSummary {
+        std::string project_id;
+        std::optional<std::string> revision;
+        std::optional<std::string> active_deployment_id;
+        bool has_failing_deployment;
+        std::unordered_map<std::string, int64_t> issue_stats;
+    };
+
+    struct DeploymentJob {
+        int64_t id;
+        std::string project_id;
+        std::string user_id;
+        int priority;
+        int64_t wait_ms;
+    };
+
+    struct DeploymentQueueStats {
+        int64_t queued;
+        int64_t running;
+        int64_t oldest_wait_ms;
+
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(DeploymentQueueStats, queued, running, oldest_wait_ms)
+    };
+
     struct AdminProjectData {
         std::string id;
         std::string name;
@@ -90,6 +116,12 @@ namespace service {
         drogon::Task<TaskResult<ProjectVersion>> getProjectVersion(std::string project, std::string name) const;
         drogon::Task<TaskResult<ProjectVersion>> getDefaultProjectVersion(std::string project) const;
         drogon::Task<TaskResult<>> deleteProjectVersions(std::string project) const;
+        drogon::Task<TaskResult<ProjectVersion>> createStagingVersion(std::string project, std::string branch,
+                                                                      std::optional<std::string> deploymentId = std::nullopt) const;
+        drogon::Task<TaskResult<>> activateStagingVersion(std::string project, int64_t versionId) const;
+        drogon::Task<TaskResult<>> retireStagingVersions() const;
+        drogon::Task<TaskResult<>> deleteStagingVersion(std::string project, int64_t versionId) const;
+        drogon::Task<TaskResult<int64_t>> deleteRetiredVersions(std::chrono::seconds gracePeriod) const;
 
         drogon::Task<TaskResult<Project>> getProjectSource(std::string id) const;
         drogon::Task<TaskResult<ProjectSearchResponse>> findProjects(std::string query, std::string types, std::string sort,
@@ -101,6 +133,7 @@ namespace service {
         drogon::Task<bool> canUserLeaveProject(std::string project, std::string username) const;
 
         drogon::Task<bool> existsForRepo(std::string repo, std::string branch, std::string path) const;
+        drogon::Task<std::vector<Project>> getProjectsForRepo(std::vector<std::string> repos, std::string branch) const;
         drogon::Task<bool> existsForData(std::string id, nlohmann::json platforms) const;
 
         // Users
@@ -114,7 +147,6 @@ namespace service {
         drogon::Task<TaskResult<Project>> getUserProject(std::string username, std::string id) const;
 
         // Content
-        drogon::Task<TaskResult<>> refreshFlatTagItemView() const;
         drogon::Task<std::vector<std::string>> getItemSourceProjects(int64_t item) const;
         drogon::Task<std::vector<GlobalItem>> getGlobalTagItems(int64_t tagId) const;
 
@@ -131,12 +163,23 @@ namespace service {
         drogon::Task<bool> hasFailingDeployment(std::string projectId) const;
         drogon::Task<std::vector<Deployment>> getLoadingDeployments() const;
         drogon::Task<TaskResult<>> failLoadingDeployments() const;
+        drogon::Task<TaskResult<>> setDeploymentMetrics(std::string id, std::string metrics) const;
         drogon::Task<std::vector<std::string>> getUndeployedProjects() const;
+        drogon::Task<TaskResult<ProjectSummary>> getProjectSummary(std::string projectId) const;
+        drogon::Task<std::unordered_map<std::string, ProjectSummary>> getProjectSummaries(std::vector<std::string> projectIds) const;
+
+        // Deployment jobs
+        drogon::Task<TaskResult<>> enqueueDeploymentJob(std::string projectId, std::string userId, int priority, int64_t delayMs) const;
+        drogon::Task<TaskResult<DeploymentJob>> claimDeploymentJob() const;
+        drogon::Task<TaskResult<>> completeDeploymentJob(int64_t id) const;
+        drogon::Task<TaskResult<>> requeueRunningDeploymentJobs() const;
+        drogon::Task<DeploymentQueueStats> getDeploymentQueueStats() const;
 
         // Issues
         drogon::Task<TaskResult<ProjectIssue>> getProjectIssue(std::string deploymentId, ProjectIssueLevel level, ProjectIssueType type,
                                                                std::string file) const;
         drogon::Task<std::vector<ProjectIssue>> getDeploymentIssues(std::string deploymentId) const;
+        drogon::Task<TaskResult<>> copyDeploymentIssues(std::string sourceDeploymentId, std::string deploymentId, ProjectIssueType type) const;
         drogon::Task<std::unordered_map<std::string, int64_t>> getActiveProjectIssueStats(std::string projectId) const;
 
         drogon::Task<PaginatedData<Report>> getReports(int page) const;
@@ -5,13 +5,6 @@ using namespace drogon;
 using namespace drogon::orm;
 
 namespace service {
-    Task<TaskResult<>> Database::refreshFlatTagItemView() const {
-        co_return co_await handleDatabaseOperation([](const DbClientPtr &client) -> Task<> {
-            // language=postgresql
-            co_await client->execSqlCoro("REFRESH MATERIALIZED VIEW tag_item_flat;");
-        });
-    }
-
     // TODO Bind to project
     Task<std::vector<GlobalItem>> Database::getGlobalTagItems(int64_t tagId) const {
         // language=postgresql
@@ -22,7 +15,8 @@ namespace service {
                                        LEFT JOIN project_version ver ON ver.id = pitem.version_id \
                                        WHERE parent IN (SELECT ptag.id FROM project_tag ptag \
                                            JOIN tag t on ptag.tag_id = t.id \
-                                           WHERE t.id = $1)";
+                                           WHERE t.id = $1) \
+                                       AND ver.live";
         const auto res = co_await handleDatabaseOperation([&, tagId](const DbClientPtr &client) -> Task<std::vector<GlobalItem>> {
             const auto results = co_await client->execSqlCoro(query, tagId);
             std::vector<GlobalItem> tagItems;
@@ -10,7 +10,7 @@ namespace service {
     Task<PaginatedData<DeploymentData>> Database::getDeployments(const std::string projectId, const int page) const {
         // language=postgresql
         static constexpr auto query = "SELECT id, project_id, revision ->> 'hash' hash, revision ->> 'message' message, status, user_id, \
-                                              active, created_at FROM deployment \
+                                              active, created_at, metrics FROM deployment \
                                        WHERE project_id = $1 \
                                        ORDER BY created_at DESC";
 
@@ -27,6 +27,9 @@ namespace service {
                 const auto createdAt = row.at("created_at").as<std::string>();
                 data.created_at = formatDateTimeISO(createdAt);
                 data.active = row.at("active").as<bool>();
+                if (const auto metrics = row.at("metrics"); !metrics.isNull()) {
+                    data.metrics = nlohmann::json::parse(metrics.as<std::string>());
+                }
                 return data;
             },
             projectId);
@@ -98,6 +101,14 @@ namespace service {
         });
     }
 
+    Task<TaskResult<>> Database::setDeploymentMetrics(const std::string id, const std::string metrics) const {
+        // language=postgresql
+        static constexpr auto query = "UPDATE deployment SET metrics = $2::jsonb WHERE id = $1";
+
+        co_return co_await handleDatabaseOperation(
+            [id, metrics](const DbClientPtr &client) -> Task<> { co_await client->execSqlCoro(query, id, metrics); });
+    }
+
     Task<std::vector<std::string>> Database::getUndeployedProjects() const {
         // language=postgresql
         static constexpr auto query = "SELECT project.id FROM project \
@@ -120,4 +131,162 @@ namespace service {
         });
         co_return res.value_or({});
     }
+
+    Task<TaskResult<ProjectSummary>> Database::getProjectSummary(const std::string projectId) const {
+        auto summaries = co_await getProjectSummaries({projectId});
+        const auto it = summaries.find(projectId);
+        if (it == summaries.end()) {
+            co_return Error::ErrNotFound;
+        }
+        co_return it->second;
+    }
+
+    Task<std::unordered_map<std::string, ProjectSummary>> Database::getProjectSummaries(const std::vector<std::string> projectIds) const {
+        // language=postgresql
+        static constexpr auto query = "SELECT p.id, latest_success.revision, active.id AS active_deployment_id, \
+                                              coalesce(latest.status = $2, FALSE) AS has_failing_deployment, issues.stats \
+                                       FROM jsonb_array_elements_text($1::jsonb) AS ids(id) \
+                                       JOIN project p ON p.id = ids.id \
+                                       LEFT JOIN deployment active ON active.project_id = p.id AND active.active \
+                                       LEFT JOIN LATERAL ( \
+                                           SELECT d.id, d.revision FROM deployment d \
+                                           WHERE d.project_id = p.id AND d.status = $3 \
+                                           ORDER BY d.created_at DESC LIMIT 1 \
+                                       ) latest_success ON TRUE \
+                                       LEFT JOIN LATERAL ( \
+                                           SELECT d.status FROM deployment d \
+                                           WHERE d.project_id = p.id \
+                                           ORDER BY d.created_at DESC LIMIT 1 \
+                                       ) latest ON TRUE \
+                                       LEFT JOIN LATERAL ( \
+                                           SELECT jsonb_object_agg(level, count) AS stats FROM ( \
+                                               SELECT i.level, count(i.level) AS count FROM project_issue i \
+                                               JOIN deployment d ON d.id = i.deployment_id \
+                                               WHERE d.project_id = p.id AND d.active \
+                                               GROUP BY i.level \
+                                           ) s \
+                                       ) issues ON TRUE";
+
+        if (projectIds.empty()) {
+            co_return {};
+        }
+
+        const auto res = co_await handleDatabaseOperation(
+            [projectIds](const DbClientPtr &client) -> Task<std::unordered_map<std::string, ProjectSummary>> {
+                std::unordered_map<std::string, ProjectSummary> summaries;
+
+                const auto rows = co_await client->execSqlCoro(query, nlohmann::json(projectIds).dump(),
+                                                               enumToStr(DeploymentStatus::ERROR), enumToStr(DeploymentStatus::SUCCESS));
+                for (const auto &row: rows) {
+                    ProjectSummary summary;
+                    summary.project_id = row["id"].as<std::string>();
+                    if (!row["revision"].isNull()) {
+                        summary.revision = row["revision"].as<std::string>();
+                    }
+                    if (!row["active_deployment_id"].isNull()) {
+                        summary.active_deployment_id = row["active_deployment_id"].as<std::string>();
+                    }
+                    summary.has_failing_deployment = row["has_failing_deployment"].as<bool>();
+                    if (!row["stats"].isNull()) {
+                        for (const auto stats = nlohmann::json::parse(row["stats"].as<std::string>()); const auto &[level, count]: stats.items()) {
+                            summary.issue_stats.emplace(level, count.get<int64_t>());
+                        }
+                    }
+
+                    summaries.emplace(summary.project_id, summary);
+                }
+
+                co_return summaries;
+            });
+        co_return res.value_or({});
+    }
+
+    Task<TaskResult<>> Database::enqueueDeploymentJob(const std::string projectId, const std::string userId, const int priority,
+                                                      const int64_t delayMs) const {
+        // Repeated requests extend the delay of a queued job, unless one of them has a higher priority
+        // language=postgresql
+        static constexpr auto query = "INSERT INTO deployment_job (project_id, user_id, priority, run_after) \
+                                       VALUES ($1, nullif($2, ''), $3, CURRENT_TIMESTAMP + $4 * interval '1 millisecond') \
+                                       ON CONFLICT (project_id) WHERE status = 'queued' \
+                                       DO UPDATE SET priority = greatest(deployment_job.priority, excluded.priority), \
+                                                     user_id = coalesce(excluded.user_id, deployment_job.user_id), \
+                                                     run_after = CASE \
+                                                         WHEN excluded.priority > deployment_job.priority THEN excluded.run_after \
+                                                         WHEN excluded.priority < deployment_job.priority THEN deployment_job.run_after \
+                                                         ELSE greatest(deployment_job.run_after, excluded.run_after) \
+                                                     END";
+
+        co_return co_await handleDatabaseOperation([projectId, userId, priority, delayMs](const DbClientPtr &client) -> Task<> {
+            co_await client->execSqlCoro(query, projectId, userId, priority, delayMs);
+        });
+    }
+
+    Task<TaskResult<DeploymentJob>> Database::claimDeploymentJob() const {
+        // Jobs for projects that are already being deployed wait for the running job to finish
+        // language=postgresql
+        static constexpr auto query = "UPDATE deployment_job SET status = 'running', started_at = CURRENT_TIMESTAMP \
+                                       WHERE id = ( \
+                                           SELECT j.id FROM deployment_job j \
+                                           WHERE j.status = 'queued' \
+                                             AND j.run_after <= CURRENT_TIMESTAMP \
+                                             AND NOT exists( \
+                                                 SELECT * FROM deployment_job r \
+                                                 WHERE r.project_id = j.project_id AND r.status = 'running' \
+                                             ) \
+                                           ORDER BY j.priority DESC, j.created_at \
+                                           LIMIT 1 \
+                                           FOR UPDATE SKIP LOCKED \
+                                       ) \
+                                       RETURNING id, project_id, coalesce(user_id, '') AS user_id, priority, \
+                                                 (extract(EPOCH FROM started_at - created_at) * 1000)::bigint AS wait_ms";
+
+        co_return co_await handleDatabaseOperation([](const DbClientPtr &client) -> Task<DeploymentJob> {
+            const auto rows = co_await client->execSqlCoro(query);
+            if (rows.empty()) {
+                throw DrogonDbException{};
+            }
+
+            const auto &row = rows.front();
+            co_return DeploymentJob{.id = row["id"].as<int64_t>(),
+                                    .project_id = row["project_id"].as<std::string>(),
+                                    .user_id = row["user_id"].as<std::string>(),
+                                    .priority = row["priority"].as<int>(),
+                                    .wait_ms = row["wait_ms"].as<int64_t>()};
+        });
+    }
+
+    Task<TaskResult<>> Database::completeDeploymentJob(const int64_t id) const {
+        co_return co_await handleDatabaseOperation([id](const DbClientPtr &client) -> Task<> {
+            // language=postgresql
+            co_await client->execSqlCoro("DELETE FROM deployment_job WHERE id = $1", id);
+        });
+    }
+
+    Task<TaskResult<>> Database::requeueRunningDeploymentJobs() const {
+        co_return co_await handleDatabaseOperation([](const DbClientPtr &client) -> Task<> {
+            // Interrupted jobs are superseded by queued jobs of the same project
+            // language=postgresql
+            co_await client->execSqlCoro("DELETE FROM deployment_job r WHERE r.status = 'running' \
+                                          AND exists(SELECT * FROM deployment_job q WHERE q.project_id = r.project_id AND q.status = 'queued')");
+            // language=postgresql
+            co_await client->execSqlCoro("UPDATE deployment_job SET status = 'queued', started_at = NULL WHERE status = 'running'");
+        });
+    }
+
+    Task<DeploymentQueueStats> Database::getDeploymentQueueStats() const {
+        // language=postgresql
+        static constexpr auto query = "SELECT count(*) FILTER (WHERE status = 'queued') AS queued, \
+                                              count(*) FILTER (WHERE status = 'running') AS running, \
+                                              coalesce(extract(EPOCH FROM CURRENT_TIMESTAMP - min(created_at) FILTER (WHERE status = 'queued')) * 1000, 0)::bigint AS oldest_wait_ms \
+                                       FROM deployment_job";
+
+        const auto res = co_await handleDatabaseOperation([](const DbClientPtr &client) -> Task<DeploymentQueueStats> {
+            const auto rows = co_await client->execSqlCoro(query);
+            const auto &row = rows.front();
+            co_return DeploymentQueueStats{.queued = row["queued"].as<int64_t>(),
+                                           .running = row["running"].as<int64_t>(),
+                                           .oldest_wait_ms = row["oldest_wait_ms"].as<int64_t>()};
+        });
+        co_return res.value_or(DeploymentQueueStats{});
+    }
 }
@@ -32,6 +32,18 @@ namespace service {
         co_return res.value_or({});
     }
 
+    Task<TaskResult<>> Database::copyDeploymentIssues(const std::string sourceDeploymentId, const std::string deploymentId,
+                                                      const ProjectIssueType type) const {
+        // language=postgresql
+        static constexpr auto query = "INSERT INTO project_issue (level, deployment_id, type, subject, details, file, version_name) \
+                                       SELECT level, $2, type, subject, details, file, version_name FROM project_issue \
+                                       WHERE deployment_id = $1 AND type = $3";
+
+        co_return co_await handleDatabaseOperation([sourceDeploymentId, deploymentId, type](const DbClientPtr &client) -> Task<> {
+            co_await client->execSqlCoro(query, sourceDeploymentId, deploymentId, enumToStr(type));
+        });
+    }
+
     Task<std::unordered_map<std::string, int64_t>> Database::getActiveProjectIssueStats(std::string projectId) const {
         // language=postgresql
         static constexpr auto query = "SELECT level, count(level) AS count FROM project_issue \
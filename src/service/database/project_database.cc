@@ -49,28 +49,71 @@ namespace service {
         });
     }
 
-    Task<TaskResult<>> ProjectDatabaseAccess::addProjectItem(const std::string item) const {
+    // Conflicting rows are skipped without being locked or rewritten, so concurrent ingests do not wait on each other.
+    // Locations that already existed are then looked up by a second statement, whose snapshot also includes rows
+    // committed by concurrent ingests after the insert started.
+    Task<TaskResult<LocationIds>> ProjectDatabaseAccess::upsertLocations(const std::string insertQuery, const std::string selectQuery,
+                                                                         const std::vector<std::string> locs) const {
+        co_return co_await handleDatabaseOperation([&](const DbClientPtr &client) -> Task<LocationIds> {
+            LocationIds ids;
+            for (const auto &row: co_await client->execSqlCoro(insertQuery, nlohmann::json(locs).dump())) {
+                ids.emplace(row["loc"].as<std::string>(), row["id"].as<int64_t>());
+            }
+
+            std::vector<std::string> existing;
+            for (const auto &loc: locs) {
+                if (!ids.contains(loc)) {
+                    existing.push_back(loc);
+                }
+            }
+            if (!existing.empty()) {
+                for (const auto &row: co_await client->execSqlCoro(selectQuery, nlohmann::json(existing).dump())) {
+                    ids.emplace(row["loc"].as<std::string>(), row["id"].as<int64_t>());
+                }
+            }
+            co_return ids;
+        });
+    }
+
+    Task<TaskResult<LocationIds>> ProjectDatabaseAccess::upsertItems(const std::vector<std::string> items) const {
+        // language=postgresql
+        static constexpr auto insertQuery = "INSERT INTO item (loc) \
+                                             SELECT DISTINCT loc FROM jsonb_array_elements_text($1::jsonb) AS loc \
+                                             ON CONFLICT DO NOTHING \
+                                             RETURNING id, loc";
+        // language=postgresql
+        static constexpr auto selectQuery = "SELECT id, loc FROM item WHERE loc IN (SELECT jsonb_array_elements_text($1::jsonb))";
+        co_return co_await upsertLocations(insertQuery, selectQuery, items);
+    }
+
+    Task<TaskResult<LocationIds>> ProjectDatabaseAccess::upsertTags(const std::vector<std::string> tags) const {
+        // language=postgresql
+        static constexpr auto insertQuery = "INSERT INTO tag (loc) \
+                                             SELECT DISTINCT loc FROM jsonb_array_elements_text($1::jsonb) AS loc \
+                                             ON CONFLICT DO NOTHING \
+                                             RETURNING id, loc";
+        // language=postgresql
+        static constexpr auto selectQuery = "SELECT id, loc FROM tag WHERE loc IN (SELECT jsonb_array_elements_text($1::jsonb))";
+        co_return co_await upsertLocations(insertQuery, selectQuery, tags);
+    }
+
+    Task<TaskResult<>> ProjectDatabaseAccess::addProjectItems(const std::vector<int64_t> items) const {
         // language=postgresql
         static constexpr auto query = "INSERT INTO project_item (item_id, version_id) \
-                                       SELECT id, $2 FROM item WHERE loc = $1 \
+                                       SELECT id::bigint, $2 FROM jsonb_array_elements_text($1::jsonb) AS id \
                                        ON CONFLICT DO NOTHING";
-        co_return co_await handleDatabaseOperation([&, item](const DbClientPtr &client) -> Task<> {
-            // language=postgresql
-            co_await client->execSqlCoro("INSERT INTO item VALUES (DEFAULT, $1) ON CONFLICT DO NOTHING", item);
-            co_await client->execSqlCoro(query, item, versionId_);
+        co_return co_await handleDatabaseOperation([&, items](const DbClientPtr &client) -> Task<> {
+            co_await client->execSqlCoro(query, nlohmann::json(items).dump(), versionId_);
         });
     }
 
-    Task<TaskResult<>> ProjectDatabaseAccess::addTag(const std::string tag) const {
+    Task<TaskResult<>> ProjectDatabaseAccess::addTags(const std::vector<int64_t> tags) const {
         // language=postgresql
         static constexpr auto query = "INSERT INTO project_tag (tag_id, version_id) \
-                                       SELECT id, $2 FROM tag WHERE loc = $1 \
+                                       SELECT id::bigint, $2 FROM jsonb_array_elements_text($1::jsonb) AS id \
                                        ON CONFLICT DO NOTHING";
-
-        co_return co_await handleDatabaseOperation([&, tag](const DbClientPtr &client) -> Task<> {
-            // language=postgresql
-            co_await client->execSqlCoro("INSERT INTO tag VALUES (DEFAULT, $1) ON CONFLICT DO NOTHING", tag);
-            co_await client->execSqlCoro(query, tag, versionId_);
+        co_return co_await handleDatabaseOperation([&, tags](const DbClientPtr &client) -> Task<> {
+            co_await client->execSqlCoro(query, nlohmann::json(tags).dump(), versionId_);
         });
     }
 
@@ -95,42 +138,47 @@ namespace service {
         co_return res.value_or({});
     }
 
-    Task<TaskResult<>> ProjectDatabaseAccess::addTagItemEntry(const std::string tag, const std::string item) const {
+    // Entries are passed as a jsonb array of [parent, child] tag and item id pairs
+    Task<TaskResult<>> ProjectDatabaseAccess::addTagItemEntries(const std::vector<std::pair<int64_t, int64_t>> entries) const {
         // language=postgresql
-        static constexpr auto tagItemQuery = "INSERT INTO tag_item (tag_id, item_id) \
-                                              SELECT pt.id, pip.id FROM project_tag pt CROSS JOIN project_item pip \
-                                              JOIN tag ON tag.id = pt.tag_id \
-                                              JOIN item ON item.id = pip.item_id \
-                                              WHERE pt.version_id = $1 \
-                                                AND (pip.version_id = $1 OR pip.version_id = $2) \
-                                                AND tag.loc = $3 AND item.loc = $4 \
+        static constexpr auto tagItemQuery = "INSERT INTO tag_item (tag_id, version_id, item_id, item_version_id) \
+                                              SELECT pt.id, pt.version_id, pip.id, pip.version_id FROM jsonb_array_elements($3::jsonb) e \
+                                              JOIN project_tag pt ON pt.tag_id = (e ->> 0)::bigint AND pt.version_id = $1 \
+                                              JOIN project_item pip ON pip.item_id = (e ->> 1)::bigint \
+                                                  AND (pip.version_id = $1 OR pip.version_id = $2) \
                                               ON CONFLICT DO NOTHING";
-        co_return co_await handleDatabaseOperation([&, tag, item](const DbClientPtr &client) -> Task<> {
+        co_return co_await handleDatabaseOperation([&, entries](const DbClientPtr &client) -> Task<> {
             const auto virtualVersionId = global::virtualProject->getProjectVersion().getValueOfId();
-            co_await client->execSqlCoro(tagItemQuery, versionId_, virtualVersionId, tag, item);
+            co_await client->execSqlCoro(tagItemQuery, versionId_, virtualVersionId, nlohmann::json(entries).dump());
         });
     }
 
-    Task<TaskResult<>> ProjectDatabaseAccess::addTagTagEntry(const std::string parentTag, const std::string childTag) const {
+    Task<TaskResult<>> ProjectDatabaseAccess::addTagTagEntries(const std::vector<std::pair<int64_t, int64_t>> entries) const {
         // language=postgresql
-        static constexpr auto tagTagQuery = "INSERT INTO tag_tag (parent, child) \
-                                             SELECT tp.id, tc.id FROM project_tag tp CROSS JOIN project_tag tc \
-                                             JOIN tag p ON p.id = tp.tag_id \
-                                             JOIN tag c ON c.id = tc.tag_id \
-                                             WHERE tp.version_id = $1 \
-                                               AND (tc.version_id = $1 OR tc.version_id = $2) \
-                                               AND p.loc = $3 AND c.loc = $4 \
+        static constexpr auto tagTagQuery = "INSERT INTO tag_tag (parent, version_id, child, child_version_id) \
+                                             SELECT tp.id, tp.version_id, tc.id, tc.version_id FROM jsonb_array_elements($3::jsonb) e \
+                                             JOIN project_tag tp ON tp.tag_id = (e ->> 0)::bigint AND tp.version_id = $1 \
+                                             JOIN project_tag tc ON tc.tag_id = (e ->> 1)::bigint \
+                                                 AND (tc.version_id = $1 OR tc.version_id = $2) \
                                              ON CONFLICT DO NOTHING";
-        co_return co_await handleDatabaseOperation([&, parentTag, childTag](const DbClientPtr &client) -> Task<> {
+        co_return co_await handleDatabaseOperation([&, entries](const DbClientPtr &client) -> Task<> {
             const auto virtualVersionId = global::virtualProject->getProjectVersion().getValueOfId();
-            co_await client->execSqlCoro(tagTagQuery, versionId_, virtualVersionId, parentTag, childTag);
+            co_await client->execSqlCoro(tagTagQuery, versionId_, virtualVersionId, nlohmann::json(entries).dump());
         });
     }
 
+    // Only tags of this version and tags from other versions that include them are recomputed
+    Task<TaskResult<>> ProjectDatabaseAccess::refreshFlatTagItems() const {
+        // language=postgresql
+        static constexpr auto query = "SELECT refresh_tag_item_flat($1)";
+        co_return co_await handleDatabaseOperation(
+            [&](const DbClientPtr &client) -> Task<> { co_await client->execSqlCoro(query, versionId_); });
+    }
+
     Task<PaginatedData<ProjectContent>> ProjectDatabaseAccess::getProjectItemsDev(const std::string searchQuery, const int page) const {
         // language=postgresql
         static constexpr auto query = "SELECT pver.project_id, item.loc, path FROM project_item pitem \
-                                       LEFT JOIN project_item_page pip ON pitem.id = pip.item_id \
+                                       LEFT JOIN project_item_page pip ON pitem.id = pip.item_id AND pip.version_id = pitem.version_id \
                                        JOIN item ON item.id = pitem.item_id \
                                        JOIN project_version pver on pitem.version_id = pver.id \
                                        WHERE pitem.version_id = $1 AND (pip IS NULL OR starts_with(pip.path, '.content/')) \
@@ -155,7 +203,7 @@ namespace service {
                                            JOIN project_item pitem ON pitem.id = flat.child \
                                            JOIN project_version pver on pitem.version_id = pver.id \
                                            JOIN item ON item.id = pitem.item_id \
-                                           LEFT JOIN project_item_page pip ON pitem.id = pip.item_id \
+                                           LEFT JOIN project_item_page pip ON pitem.id = pip.item_id AND pip.version_id = pitem.version_id \
                                         WHERE ptag.version_id = $1 \
                                             AND (pitem.version_id = $1 OR pitem.version_id = $3) AND t.loc = '{}' \
                                             AND (pip IS NULL OR starts_with(pip.path, '.content/')) \
@@ -203,7 +251,7 @@ namespace service {
     Task<int> ProjectDatabaseAccess::getProjectContentCount() const {
         // language=postgresql
         static constexpr auto query = "SELECT count(*) FROM project_item pitem \
-                                       JOIN project_item_page pip ON pitem.id = pip.item_id \
+                                       JOIN project_item_page pip ON pitem.id = pip.item_id AND pip.version_id = pitem.version_id \
                                        WHERE pitem.version_id = $1 AND starts_with(pip.path, '.content/')";
 
         const auto res = co_await handleDatabaseOperation([&](const DbClientPtr &client) -> Task<int> {
@@ -216,10 +264,29 @@ namespace service {
         co_return res.value_or(0);
     }
 
+    Task<int64_t> ProjectDatabaseAccess::getIngestedRowCount() const {
+        // language=postgresql
+        static constexpr auto query = "SELECT (SELECT count(*) FROM project_item WHERE version_id = $1) \
+                                            + (SELECT count(*) FROM project_item_page WHERE version_id = $1) \
+                                            + (SELECT count(*) FROM project_tag WHERE version_id = $1) \
+                                            + (SELECT count(*) FROM tag_item WHERE version_id = $1) \
+                                            + (SELECT count(*) FROM recipe_type WHERE version_id = $1) \
+                                            + (SELECT count(*) FROM recipe WHERE version_id = $1) AS count";
+
+        const auto res = co_await handleDatabaseOperation([&](const DbClientPtr &client) -> Task<int64_t> {
+            const auto results = co_await client->execSqlCoro(query, versionId_);
+            if (results.size() != 1) {
+                throw DrogonDbException{};
+            }
+            co_return results.front().at("count").as<int64_t>();
+        });
+        co_return res.value_or(0);
+    }
+
     Task<TaskResult<std::string>> ProjectDatabaseAccess::getProjectContentPath(const std::string id) const {
         // language=postgresql
         static constexpr auto query = "SELECT path FROM project_item pitem \
-                                       JOIN project_item_page pip ON pitem.id = pip.item_id \
+                                       JOIN project_item_page pip ON pitem.id = pip.item_id AND pip.version_id = pitem.version_id \
                                        JOIN item i ON pitem.item_id = i.id \
                                        WHERE pitem.version_id = $1 AND i.loc = $2";
 
@@ -234,28 +301,82 @@ namespace service {
         });
     }
 
-    Task<TaskResult<>> ProjectDatabaseAccess::addProjectContentPage(const std::string id, const std::string path) const {
+    // Pages are passed as a jsonb array of [item id, path] pairs
+    Task<TaskResult<>> ProjectDatabaseAccess::addProjectContentPages(const std::vector<std::pair<int64_t, std::string>> pages) const {
+        // language=postgresql
+        static constexpr auto pageQuery = "INSERT INTO project_item_page (item_id, version_id, path) \
+                                           SELECT pitem.id as item_id, pitem.version_id, p ->> 1 as path \
+                                           FROM jsonb_array_elements($1::jsonb) p \
+                                           JOIN project_item pitem ON pitem.item_id = (p ->> 0)::bigint \
+                                           WHERE pitem.version_id = $2";
+        co_return co_await handleDatabaseOperation([&, pages](const DbClientPtr &client) -> Task<> {
+            co_await client->execSqlCoro(pageQuery, nlohmann::json(pages).dump(), versionId_);
+        });
+    }
+
+    Task<TaskResult<>> ProjectDatabaseAccess::addRecipeTypes(const std::vector<std::string> types) const {
+        // language=postgresql
+        static constexpr auto query = "INSERT INTO recipe_type (loc, version_id) \
+                                       SELECT loc, $2 FROM jsonb_array_elements_text($1::jsonb) AS loc";
+        co_return co_await handleDatabaseOperation([&, types](const DbClientPtr &client) -> Task<> {
+            co_await client->execSqlCoro(query, nlohmann::json(types).dump(), versionId_);
+        });
+    }
+
+    // Recipes and their ingredients are inserted in one statement
+    Task<TaskResult<>> ProjectDatabaseAccess::addRecipes(const std::vector<IngestedRecipe> recipes) const {
         // language=postgresql
-        static constexpr auto pageQuery = "INSERT INTO project_item_page (item_id, path) \
-                                           SELECT pitem.id as item_id, $1 as path \
-                                           FROM project_item pitem \
-                                           JOIN item i ON pitem.item_id = i.id \
-                                           WHERE i.loc = $2 AND pitem.version_id = $3";
+        static constexpr auto query = "WITH data AS (SELECT * FROM jsonb_to_recordset($2::jsonb) AS r(loc text, type_id bigint, ingredients jsonb)), \
+                                            inserted AS ( \
+                                                INSERT INTO recipe (version_id, loc, type_id, type_version_id) \
+                                                SELECT $1, data.loc, data.type_id, rt.version_id FROM data \
+                                                JOIN recipe_type rt ON rt.id = data.type_id \
+                                                RETURNING id, loc \
+                                            ), \
+                                            ingredient AS ( \
+                                                SELECT inserted.id AS recipe_id, i.* FROM inserted \
+                                                JOIN data ON data.loc = inserted.loc \
+                                                CROSS JOIN jsonb_to_recordset(data.ingredients) AS i(id bigint, slot text, count int, input bool, tag bool) \
+                                            ), \
+                                            item_ingredient AS ( \
+                                                INSERT INTO recipe_ingredient_item (recipe_id, version_id, item_id, slot, count, input) \
+                                                SELECT ingredient.recipe_id, $1, ingredient.id, ingredient.slot, ingredient.count, ingredient.input \
+                                                FROM ingredient \
+                                                WHERE NOT ingredient.tag \
+                                                ON CONFLICT DO NOTHING \
+                                            ) \
+                                       INSERT INTO recipe_ingredient_tag (recipe_id, version_id, tag_id, slot, count, input) \
+                                       SELECT ingredient.recipe_id, $1, ingredient.id, ingredient.slot, ingredient.count, ingredient.input \
+                                       FROM ingredient \
+                                       WHERE ingredient.tag \
+                                       ON CONFLICT DO NOTHING";
+
+        nlohmann::json data(nlohmann::json::value_t::array);
+        for (const auto &[loc, typeId, ingredients]: recipes) {
+            nlohmann::json ingredientData(nlohmann::json::value_t::array);
+            for (const auto &[id, slot, count, input, isTag]: ingredients) {
+                ingredientData.push_back({{"id", id}, {"slot", slot}, {"count", count}, {"input", input}, {"tag", isTag}});
+            }
+            data.push_back({{"loc", loc}, {"type_id", typeId}, {"ingredients", ingredientData}});
+        }
+
         co_return co_await handleDatabaseOperation(
-            [&, id, path](const DbClientPtr &client) -> Task<> { co_await client->execSqlCoro(pageQuery, path, id, versionId_); });
+            [&, json = data.dump()](const DbClientPtr &client) -> Task<> { co_await client->execSqlCoro(query, versionId_, json); });
     }
 
     Task<size_t> ProjectDatabaseAccess::addRecipeWorkbenches(const std::string recipeType, const std::vector<std::string> items) const {
+        // Workbench items must come from this project or the game, as other projects' versions can be dropped at any time
         // language=postgresql
-        static constexpr auto query = "INSERT INTO recipe_workbench (type_id, item_id) \
-                                       SELECT r.id, pitem.id \
+        static constexpr auto query = "INSERT INTO recipe_workbench (type_id, version_id, item_id, item_version_id) \
+                                       SELECT r.id, r.version_id, pitem.id, pitem.version_id \
                                        FROM recipe_type r \
                                        JOIN project_item pitem \
                                            ON pitem.item_id IN (SELECT id FROM item i WHERE $1::jsonb ? i.loc) \
+                                           AND (pitem.version_id = $3 OR pitem.version_id = $4) \
                                        WHERE r.loc = $2 \
                                        AND r.version_id = $3";
         const auto res = co_await handleDatabaseOperation([&, recipeType, items](const DbClientPtr &client) -> Task<size_t> {
-            const auto results = co_await client->execSqlCoro(query, unparkourJson(items), recipeType, versionId_);
+            const auto results = co_await client->execSqlCoro(query, unparkourJson(items), recipeType, versionId_, mcVersionId());
             co_return results.affectedRows();
         });
         co_return res.value_or(0);
@@ -285,10 +406,28 @@ namespace service {
         });
     }
 
+    // Recipe types of the project take precedence over builtin ones
+    Task<std::unordered_map<std::string, int64_t>> ProjectDatabaseAccess::getRecipeTypeIds(const std::vector<std::string> types) const {
+        // language=postgresql
+        static constexpr auto query = "SELECT DISTINCT ON (loc) loc, id FROM recipe_type \
+                                       WHERE (version_id = $1 OR version_id = $2) \
+                                         AND loc IN (SELECT jsonb_array_elements_text($3::jsonb)) \
+                                       ORDER BY loc, version_id = $1 DESC";
+        const auto res = co_await handleDatabaseOperation([&, types](const DbClientPtr &client) -> Task<std::unordered_map<std::string, int64_t>> {
+            const auto results = co_await client->execSqlCoro(query, versionId_, mcVersionId(), nlohmann::json(types).dump());
+            std::unordered_map<std::string, int64_t> ids;
+            for (const auto &row: results) {
+                ids.emplace(row["loc"].as<std::string>(), row["id"].as<int64_t>());
+            }
+            co_return ids;
+        });
+        co_return res.value_or({});
+    }
+
     Task<std::vector<std::string>> ProjectDatabaseAccess::getRecipesForItem(std::string item) const {
         // language=postgresql
         static constexpr auto query = "SELECT r.loc FROM recipe r \
-                                       JOIN recipe_ingredient_item ritem ON ritem.recipe_id = r.id \
+                                       JOIN recipe_ingredient_item ritem ON ritem.recipe_id = r.id AND ritem.version_id = r.version_id \
                                        JOIN item ON item.id = ritem.item_id \
                                        WHERE NOT ritem.input AND r.version_id = $1 AND item.loc = $2";
         const auto res = co_await handleDatabaseOperation([&, item](const DbClientPtr &client) -> Task<std::vector<std::string>> {
@@ -305,13 +444,13 @@ namespace service {
     Task<std::vector<ContentUsage>> ProjectDatabaseAccess::getObtainableItemsBy(std::string item) const {
         // language=postgresql
         static constexpr auto query = "SELECT ver.project_id, item.id, item.loc, pip.path FROM recipe r \
-                                       JOIN recipe_ingredient_item ri ON r.id = ri.recipe_id \
+                                       JOIN recipe_ingredient_item ri ON r.id = ri.recipe_id AND ri.version_id = r.version_id \
                                        JOIN project_item pitem ON ri.item_id = pitem.item_id \
                                        JOIN project_version ver ON pitem.version_id = ver.id \
                                        JOIN item ON pitem.item_id = item.id \
-                                       LEFT JOIN project_item_page pip ON pitem.id = pip.item_id \
+                                       LEFT JOIN project_item_page pip ON pitem.id = pip.item_id AND pip.version_id = pitem.version_id \
                                        WHERE (r.version_id = $1 OR r.version_id = $2) \
-                                       AND NOT ri.input \
+                                       AND ver.live AND NOT ri.input \
                                        AND ( \
                                            EXISTS ( \
                                                SELECT 1 FROM recipe_ingredient_item ri_sub \
@@ -349,7 +488,7 @@ namespace service {
                                        JOIN project_item pitem ON recipe_workbench.item_id = pitem.id \
                                        JOIN item ON pitem.item_id = item.id \
                                        JOIN project_version ver ON pitem.version_id = ver.id \
-                                       LEFT JOIN project_item_page pip ON pitem.id = pip.item_id \
+                                       LEFT JOIN project_item_page pip ON pitem.id = pip.item_id AND pip.version_id = pitem.version_id \
                                        WHERE (ver.id = $1 OR ver.id = $2) AND type_id = $3";
 
         const auto res = co_await handleDatabaseOperation([&, id](const DbClientPtr &client) -> Task<std::vector<ContentUsage>> {
@@ -4,6 +4,7 @@
 #include <models/ProjectVersion.h>
 #include <models/RecipeType.h>
 #include <service/project/resolved.h>
+#include <service/storage/ingestor/recipe/recipe_parser.h>
 #include "database.h"
 #include "database_base.h"
 
@@ -20,6 +21,22 @@ namespace service {
         std::string loc;
     };
 
+    // Resource location -> item or tag id
+    using LocationIds = std::unordered_map<std::string, int64_t>;
+
+    struct IngestedIngredient {
+        int64_t id;
+        std::string slot;
+        int count;
+        bool input;
+        bool isTag;
+    };
+    struct IngestedRecipe {
+        std::string loc;
+        int64_t typeId;
+        std::vector<IngestedIngredient> ingredients;
+    };
+
     class ProjectDatabaseAccess : public DatabaseBase {
     public:
         explicit ProjectDatabaseAccess(const ProjectBase &);
@@ -61,13 +78,18 @@ namespace service {
         drogon::Task<PaginatedData<ProjectVersion>> getVersionsDev(std::string query, int page) const;
         drogon::Task<TaskResult<>> deleteUnusedVersions(std::vector<std::string> keep) const;
 
-        // Project content registration
-        drogon::Task<TaskResult<>> addProjectItem(std::string item) const;
-        drogon::Task<TaskResult<>> addTag(std::string tag) const;
+        // Project content registration, each call runs set-based statements regardless of the number of rows
+        drogon::Task<TaskResult<LocationIds>> upsertItems(std::vector<std::string> items) const;
+        drogon::Task<TaskResult<LocationIds>> upsertTags(std::vector<std::string> tags) const;
+        drogon::Task<TaskResult<>> addProjectItems(std::vector<int64_t> items) const;
+        drogon::Task<TaskResult<>> addTags(std::vector<int64_t> tags) const;
         drogon::Task<std::vector<Item>> getProjectTagItemsFlat(int64_t tag) const;
-        drogon::Task<TaskResult<>> addTagItemEntry(std::string tag, std::string item) const;
-        drogon::Task<TaskResult<>> addTagTagEntry(std::string parentTag, std::string childTag) const;
-        drogon::Task<TaskResult<>> addProjectContentPage(std::string id, std::string path) const;
+        drogon::Task<TaskResult<>> addTagItemEntries(std::vector<std::pair<int64_t, int64_t>> entries) const;
+        drogon::Task<TaskResult<>> addTagTagEntries(std::vector<std::pair<int64_t, int64_t>> entries) const;
+        drogon::Task<TaskResult<>> refreshFlatTagItems() const;
+        drogon::Task<TaskResult<>> addProjectContentPages(std::vector<std::pair<int64_t, std::string>> pages) const;
+        drogon::Task<TaskResult<>> addRecipeTypes(std::vector<std::string> types) const;
+        drogon::Task<TaskResult<>> addRecipes(std::vector<IngestedRecipe> recipes) const;
         drogon::Task<size_t> addRecipeWorkbenches(std::string recipeType, std::vector<std::string> items) const;
 
         // Dev tables
@@ -76,11 +98,13 @@ namespace service {
         drogon::Task<PaginatedData<ProjectTag>> getProjectTagsDev(std::string searchQuery, int page) const;
         drogon::Task<PaginatedData<Recipe>> getProjectRecipesDev(std::string searchQuery, int page) const;
         drogon::Task<int> getProjectContentCount() const;
+        drogon::Task<int64_t> getIngestedRowCount() const;
         drogon::Task<TaskResult<std::string>> getProjectContentPath(std::string id) const;
 
         // Recipes
         drogon::Task<TaskResult<Recipe>> getProjectRecipe(std::string recipe) const;
         drogon::Task<TaskResult<RecipeType>> getRecipeType(std::string type) const;
+        drogon::Task<std::unordered_map<std::string, int64_t>> getRecipeTypeIds(std::vector<std::string> types) const;
 
         // Recipe item usage
         drogon::Task<std::vector<std::string>> getRecipesForItem(std::string item) const;
@@ -88,6 +112,9 @@ namespace service {
         drogon::Task<std::vector<ContentUsage>> getRecipeTypeWorkbenches(int64_t id) const;
 
     private:
+        drogon::Task<TaskResult<LocationIds>> upsertLocations(std::string insertQuery, std::string selectQuery,
+                                                              std::vector<std::string> locs) const;
+
         const ProjectBase &project_;
         const std::string projectId_;
         const int64_t versionId_;
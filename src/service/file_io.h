@@ -0,0 +1,21 @@
+#pragma once
+
+#include <drogon/utils/coroutine.h>
+#include <trantor/net/EventLoopThreadPool.h>
+
+namespace service {
+    // Threads reserved for blocking filesystem access, keeping it off the HTTP event loops
+    extern trantor::EventLoopThreadPool fileIOThreadPool;
+
+    template<class T>
+    drogon::Task<T> supplyFileIO(std::function<T()> task) {
+        const auto currentLoop = trantor::EventLoop::getEventLoopOfCurrentThread();
+        // Plain threads can block freely
+        if (!currentLoop) {
+            co_return task();
+        }
+        const auto result = co_await drogon::queueInLoopCoro<T>(fileIOThreadPool.getNextLoop(), task);
+        co_await drogon::switchThreadCoro(currentLoop);
+        co_return result;
+    }
+}
@@ -0,0 +1,43 @@
+#include <service/auth.h>
+#include <service/cache.h>
+#include <service/database/database.h>
+#include <service/external/crowdin.h>
+#include <service/external/frontend.h>
+#include <service/external/github.h>
+#include <service/file_io.h>
+#include <service/parallel.h>
+#include <service/platforms.h>
+#include <service/project/virtual/virtual.h>
+#include <service/storage/deployment_queue.h>
+#include <service/storage/issues/issue_service.h>
+#include <service/storage/realtime.h>
+#include <service/storage/storage.h>
+#include <service/system/access_keys.h>
+#include <service/system/game_data.h>
+#include <service/system/lang.h>
+
+// Shared by every executable linking the service, each one initializes only the services it uses
+
+namespace service {
+    trantor::EventLoopThreadPool cacheAwaiterThreadPool{10};
+    trantor::EventLoopThreadPool fileIOThreadPool{8};
+    trantor::EventLoopThreadPool deploymentThreadPool{8};
+}
+
+namespace global {
+    std::shared_ptr<service::Database> database;
+    std::shared_ptr<service::MemoryCache> cache;
+    std::shared_ptr<service::GitHub> github;
+    std::shared_ptr<realtime::ConnectionManager> connections;
+    std::shared_ptr<service::Storage> storage;
+    std::shared_ptr<service::DeploymentQueue> deployments;
+    std::shared_ptr<service::IssueService> issues;
+    std::shared_ptr<service::Auth> auth;
+    std::shared_ptr<service::LangService> lang;
+    std::shared_ptr<service::GameDataService> gameData;
+    std::shared_ptr<service::Crowdin> crowdin;
+    std::shared_ptr<service::AccessKeys> accessKeys;
+    std::shared_ptr<service::FrontendService> frontend;
+    std::shared_ptr<service::Platforms> platforms;
+    std::shared_ptr<service::VirtualProject> virtualProject;
+}
@@ -0,0 +1,66 @@
+#include "parallel.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace service {
+    // Helpers may only get to run after the caller has returned, so they share ownership of the state and no longer
+    // touch the function once every index has been claimed
+    struct ParallelState {
+        size_t count;
+        std::atomic<size_t> next{0};
+        std::atomic<bool> failed{false};
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t finished = 0;
+        std::exception_ptr error;
+
+        explicit ParallelState(const size_t count) : count(count) {}
+
+        void run(const std::function<void(size_t)> &func) {
+            size_t done = 0;
+            for (auto i = next++; i < count; i = next++) {
+                if (!failed) {
+                    try {
+                        func(i);
+                    } catch (...) {
+                        std::lock_guard lock(mutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                        failed = true;
+                    }
+                }
+                done++;
+            }
+
+            if (done > 0) {
+                std::lock_guard lock(mutex);
+                finished += done;
+                if (finished == count) {
+                    condition.notify_all();
+                }
+            }
+        }
+    };
+
+    void parallelFor(const size_t count, const std::function<void(size_t)> &func, const size_t maxWorkers) {
+        if (count == 0) {
+            return;
+        }
+
+        const auto state = std::make_shared<ParallelState>(count);
+        const auto helpers = std::min({deploymentThreadPool.size(), count - 1, std::max<size_t>(maxWorkers, 1) - 1});
+        for (size_t i = 0; i < helpers; i++) {
+            deploymentThreadPool.getNextLoop()->queueInLoop([state, &func] { state->run(func); });
+        }
+        state->run(func);
+
+        std::unique_lock lock(state->mutex);
+        state->condition.wait(lock, [&] { return state->finished == count; });
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <drogon/utils/coroutine.h>
+#include <trantor/net/EventLoopThreadPool.h>
+
+namespace service {
+    // Threads shared by the heavy stages of every deployment, such as cloning, copying versions and preparing content.
+    // Concurrent deployments queue for the same bounded set of threads instead of each spawning their own.
+    extern trantor::EventLoopThreadPool deploymentThreadPool;
+
+    // Calls func for every index in [0, count) on the calling thread and on up to maxWorkers - 1 deployment threads,
+    // returning once all indices are done. The caller always takes part, so calls nested inside the pool never wait on
+    // a busy thread. Remaining indices are skipped after the first exception, which is rethrown to the caller.
+    void parallelFor(size_t count, const std::function<void(size_t)> &func, size_t maxWorkers = SIZE_MAX);
+
+    template<class T>
+    drogon::Task<T> supplyDeploymentWork(std::function<T()> task) {
+        const auto currentLoop = trantor::EventLoop::getEventLoopOfCurrentThread();
+        // Plain threads can block freely
+        if (!currentLoop) {
+            co_return task();
+        }
+        const auto result = co_await drogon::queueInLoopCoro<T>(deploymentThreadPool.getNextLoop(), task);
+        co_await drogon::switchThreadCoro(currentLoop);
+        co_return result;
+    }
+}
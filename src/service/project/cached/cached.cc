@@ -42,7 +42,7 @@ namespace service {
     Task<Json::Value> CachedProject::toJson(bool full) const { co_return co_await wrapped_->toJson(); }
     Task<Json::Value> CachedProject::toJsonVerbose() { co_return co_await wrapped_->toJsonVerbose(); }
     std::string CachedProject::getLocale() const { return wrapped_->getLocale(); }
-    bool CachedProject::hasLocale(const std::string &locale) const { return wrapped_->hasLocale(locale); }
+    Task<bool> CachedProject::hasLocale(const std::string locale) const { co_return co_await wrapped_->hasLocale(locale); }
     std::set<std::string> CachedProject::getLocales() const { return wrapped_->getLocales(); }
     Task<std::unordered_map<std::string, std::string>> CachedProject::getAvailableVersions() const {
         co_return co_await wrapped_->getAvailableVersions();
@@ -50,7 +50,9 @@ namespace service {
     Task<bool> CachedProject::hasVersion(const std::string version) const { co_return co_await wrapped_->hasVersion(version); }
     std::optional<std::string> CachedProject::getPagePath(const std::string &path) const { return wrapped_->getPagePath(path); }
     std::optional<std::string> CachedProject::getPageTitle(const std::string &path) const { return wrapped_->getPageTitle(path); }
-    TaskResult<ProjectPage> CachedProject::readPageFile(const std::string path) const { return wrapped_->readPageFile(path); }
+    Task<TaskResult<ProjectPage>> CachedProject::readPageFile(const std::string path) const {
+        co_return co_await wrapped_->readPageFile(path);
+    }
     Task<TaskResult<ProjectPage>> CachedProject::readContentPage(const std::string id) const {
         co_return co_await wrapped_->readContentPage(id);
     }
@@ -80,8 +82,8 @@ namespace service {
     Task<std::optional<std::string>> CachedProject::readLangKey(const std::string &namespace_, const std::string &key) const {
         co_return co_await wrapped_->readLangKey(namespace_, key);
     }
-    std::optional<std::filesystem::path> CachedProject::getAsset(const ResourceLocation &location) const {
-        return wrapped_->getAsset(location);
+    Task<std::optional<std::filesystem::path>> CachedProject::getAsset(const ResourceLocation location) const {
+        co_return co_await wrapped_->getAsset(location);
     }
     const ProjectFormat &CachedProject::getFormat() const {
         return wrapped_->getFormat();
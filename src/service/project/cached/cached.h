@@ -31,13 +31,13 @@ namespace service {
         ProjectDatabaseAccess &getProjectDatabase() const override;
 
         std::string getLocale() const override;
-        bool hasLocale(const std::string &locale) const override;
+        drogon::Task<bool> hasLocale(std::string locale) const override;
         std::set<std::string> getLocales() const override;
         drogon::Task<std::unordered_map<std::string, std::string>> getAvailableVersions() const override;
         drogon::Task<bool> hasVersion(std::string version) const override;
         std::optional<std::string> getPagePath(const std::string &path) const override;
         std::optional<std::string> getPageTitle(const std::string &path) const override;
-        TaskResult<ProjectPage> readPageFile(std::string path) const override;
+        drogon::Task<TaskResult<ProjectPage>> readPageFile(std::string path) const override;
         drogon::Task<TaskResult<ProjectPage>> readContentPage(std::string id) const override;
         std::optional<Frontmatter> readPageAttributes(const std::string &path) const override;
         drogon::Task<PaginatedData<ItemContentPage>> getItemContentPages(TableQueryParams params) const override;
@@ -49,7 +49,7 @@ namespace service {
         drogon::Task<TaskResult<ItemData>> getItemName(std::string loc) const override;
         drogon::Task<nlohmann::json> readItemProperties(std::string id) const override;
         drogon::Task<std::optional<std::string>> readLangKey(const std::string &namespace_, const std::string &key) const override;
-        std::optional<std::filesystem::path> getAsset(const ResourceLocation &location) const override;
+        drogon::Task<std::optional<std::filesystem::path>> getAsset(ResourceLocation location) const override;
         drogon::Task<Json::Value> toJson(bool full) const override;
         drogon::Task<Json::Value> toJsonVerbose() override;
         const ProjectFormat &getFormat() const override;
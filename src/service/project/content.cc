@@ -1,5 +1,6 @@
 #include <schemas/schemas.h>
 #include <service/database/project_database.h>
+#include <service/file_io.h>
 #include <service/project/recipe_resolver.h>
 #include <service/project/resolved.h>
 
@@ -28,7 +29,7 @@ namespace service {
 
     Task<nlohmann::json> ResolvedProject::readItemProperties(const std::string id) const {
         const auto filePath = format_.getItemPropertiesPath();
-        co_return parseItemProperties(filePath, id);
+        co_return co_await supplyFileIO<nlohmann::json>([&] { return parseItemProperties(filePath, id); });
     }
 
     void ResolvedProject::addPageMetadata(FileTree &tree) const {
@@ -50,19 +51,28 @@ namespace service {
         }
     }
 
-    Task<TaskResult<FileTree>> ResolvedProject::getProjectContents() {
+    TaskResult<FileTree> ResolvedProject::computeProjectContents() const {
         const auto contentPath = getFormat().getContentDirectoryPath();
         if (!exists(contentPath)) {
-            co_return Error::ErrNotFound;
+            return Error::ErrNotFound;
         }
         auto tree = getDirectoryTree(contentPath);
         addPageMetadata(tree);
-        co_return tree;
+        return tree;
+    }
+
+    Task<TaskResult<FileTree>> ResolvedProject::getProjectContents() {
+        co_return co_await supplyFileIO<TaskResult<FileTree>>([this]() -> TaskResult<FileTree> {
+            if (hasTreeIndex()) {
+                return readTreeIndex(CONTENT_TREE_INDEX_FILE);
+            }
+            return computeProjectContents();
+        });
     }
 
     Task<std::optional<std::string>> ResolvedProject::readLangKey(const std::string &namespace_, const std::string &key) const {
         const auto path = format_.getLanguageFilePath(namespace_);
-        const auto json = parseJsonFile(path);
+        const auto json = co_await supplyFileIO<std::optional<nlohmann::json>>([&] { return readProjectJsonFile(path); });
         if (!json || !json->is_object() || !json->contains(key)) {
             co_return std::nullopt;
         }
@@ -84,7 +94,7 @@ namespace service {
         if (!localized) {
             // Use page title instead
             if (path) {
-                if (const auto title = getPageTitle(*path)) {
+                if (const auto title = co_await supplyFileIO<std::optional<std::string>>([&] { return getPageTitle(*path); })) {
                     co_return ItemData{.name = *title, .path = *path};
                 }
             }
@@ -97,7 +107,7 @@ namespace service {
     Task<std::optional<content::GameRecipeType>> ResolvedProject::getRecipeType(const ResourceLocation &location) {
         const auto dataRoot = format_.getDataRoot();
         const auto path = dataRoot / location.namespace_ / "recipe_type" / (location.path_ + ".json");
-        const auto json = parseJsonFile(path);
+        const auto json = co_await supplyFileIO<std::optional<nlohmann::json>>([&path] { return parseJsonFile(path); });
         if (!json) {
             co_return std::nullopt;
         }
@@ -12,6 +12,7 @@
 #define PROPERTIES_PATH ".data/properties.json"
 #define WORKBENCHES_PATH ".data/workbenches.json"
 #define WIKI_META_FILE "sinytra-wiki.json"
+#define TREE_INDEX_DIR_PATH ".index"
 
 namespace fs = std::filesystem;
 
@@ -90,4 +91,12 @@ namespace service {
     fs::path V0ProjectFormat::getLanguageFilePath(const std::string &namespace_) const {
         return root_ / ASSETS_DIR_PATH / namespace_ / ASSETS_LANG_DIR_PATH / (getLocale() + ".json");
     }
+
+    fs::path V0ProjectFormat::getTreeIndexRoot() const {
+        return root_ / TREE_INDEX_DIR_PATH;
+    }
+
+    fs::path V0ProjectFormat::getTreeIndexPath(const std::string &locale, const std::string &name) const {
+        return getTreeIndexRoot() / locale / name;
+    }
 }
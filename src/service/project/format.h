@@ -5,6 +5,9 @@
 #include <optional>
 #include <service/util.h>
 
+#define DIRECTORY_TREE_INDEX_FILE "tree.json"
+#define CONTENT_TREE_INDEX_FILE "contents.json"
+
 namespace service {
     class ProjectFormat {
     public:
@@ -45,6 +48,9 @@ namespace service {
         std::filesystem::path getWorkbenchesPath() const override;
         std::filesystem::path getAssetsPath(const ResourceLocation &location) const override;
         std::filesystem::path getLanguageFilePath(const std::string &namespace_) const override;
+
+        std::filesystem::path getTreeIndexRoot() const;
+        std::filesystem::path getTreeIndexPath(const std::string &locale, const std::string &name) const;
     private:
         std::filesystem::path root_;
 
@@ -3,7 +3,9 @@
 #include <regex>
 #include <schemas/schemas.h>
 #include <service/database/project_database.h>
+#include <service/file_io.h>
 #include <service/project/resolved.h>
+#include <service/system/lang.h>
 #include <storage/gitops.h>
 
 #define NO_ICON "_none"
@@ -204,23 +206,16 @@ namespace service {
         return readPageHeading(format_.getLocalizedFilePath(removeLeadingSlash(path)));
     }
 
-    TaskResult<ProjectPage> ResolvedProject::readPageFile(std::string path) const {
-        const auto filePath = format_.getLocalizedFilePath(removeLeadingSlash(path));
-
-        std::ifstream file(filePath);
-
-        if (!file) {
-            return {Error::ErrNotFound};
+    Task<TaskResult<ProjectPage>> ResolvedProject::readPageFile(std::string path) const {
+        const auto content = co_await supplyFileIO<std::optional<std::string>>(
+            [&] { return readProjectFile(getLocalizedFilePath(removeLeadingSlash(path))); });
+        if (!content) {
+            co_return {Error::ErrNotFound};
         }
 
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-
-        file.close();
-
         const auto editUrl = formatEditUrl(project_, path);
 
-        return {ProjectPage{.content = buffer.str(), .editUrl = editUrl}};
+        co_return {ProjectPage{.content = *content, .editUrl = editUrl}};
     }
 
     Task<TaskResult<ProjectPage>> ResolvedProject::readContentPage(const std::string id) const {
@@ -228,21 +223,107 @@ namespace service {
         if (!contentPath) {
             co_return {Error::ErrNotFound};
         }
-        co_return readPageFile(*contentPath);
+        co_return co_await readPageFile(*contentPath);
+    }
+
+    Task<TaskResult<FileTree>> ResolvedProject::getDirectoryTree() {
+        co_return co_await supplyFileIO<TaskResult<FileTree>>([this]() -> TaskResult<FileTree> {
+            if (hasTreeIndex()) {
+                return readTreeIndex(DIRECTORY_TREE_INDEX_FILE);
+            }
+            return getDirectoryTree(format_.getRoot());
+        });
+    }
+
+    bool ResolvedProject::hasTreeIndex() const {
+        return hasProjectFile(format_.getTreeIndexPath(DEFAULT_LOCALE, DIRECTORY_TREE_INDEX_FILE));
+    }
+
+    TaskResult<FileTree> ResolvedProject::readTreeIndex(const std::string &name) const {
+        auto path = format_.getTreeIndexPath(getLocale(), name);
+        if (!hasProjectFile(path)) {
+            // Untranslated locales share the default locale's tree
+            path = format_.getTreeIndexPath(DEFAULT_LOCALE, name);
+        }
+
+        const auto json = readProjectJsonFile(path);
+        if (!json) {
+            return Error::ErrNotFound;
+        }
+
+        try {
+            return json->get<FileTree>();
+        } catch (const nlohmann::json::exception &e) {
+            logger_->error("Error reading tree index {} for project {}: {}", path.string(), project_.getValueOfId(), e.what());
+            return Error::ErrInternal;
+        }
+    }
+
+    Error writeTreeIndexFile(const fs::path &path, const FileTree &tree) {
+        create_directories(path.parent_path());
+
+        std::ofstream ofs(path);
+        if (!ofs) {
+            return Error::ErrInternal;
+        }
+        ofs << nlohmann::json(tree).dump();
+        ofs.close();
+
+        return Error::Ok;
     }
 
-    Task<TaskResult<FileTree>> ResolvedProject::getDirectoryTree() { co_return getDirectoryTree(format_.getRoot()); }
+    Error ResolvedProject::writeTreeIndex() const {
+        logger_->debug("Writing tree index for project {} at {}", project_.getValueOfId(), format_.getRoot().string());
+
+        auto result = Error::Ok;
+        try {
+            // Never trust index files shipped with the source repository
+            remove_all(format_.getTreeIndexRoot());
+
+            std::set<std::string> locales = getLocales();
+            locales.insert(DEFAULT_LOCALE);
+
+            for (const auto &locale: locales) {
+                ResolvedProject localized(*this);
+                localized.setLocale(locale == DEFAULT_LOCALE ? std::nullopt : std::optional{locale});
+
+                const auto tree = localized.getDirectoryTree(format_.getRoot());
+                result = writeTreeIndexFile(format_.getTreeIndexPath(locale, DIRECTORY_TREE_INDEX_FILE), tree);
+
+                if (const auto contents = localized.computeProjectContents(); contents && result == Error::Ok) {
+                    result = writeTreeIndexFile(format_.getTreeIndexPath(locale, CONTENT_TREE_INDEX_FILE), *contents);
+                }
+
+                if (result != Error::Ok) {
+                    break;
+                }
+            }
+        } catch (const std::exception &e) {
+            logger_->error("Error writing tree index: {}", e.what());
+            result = Error::ErrInternal;
+        }
+
+        // A partial index would hide pages, readers fall back to walking the tree without one
+        if (result != Error::Ok) {
+            std::error_code ec;
+            remove_all(format_.getTreeIndexRoot(), ec);
+        }
+
+        return result;
+    }
 
     Task<> validatePageFile(const FileTreeEntry &entry, const ResolvedProject &resolved,
                             const std::shared_ptr<ProjectIssueCallback> issues, const std::vector<std::string> &requiredAttributes) {
         const auto path = entry.path + DOCS_FILE_EXT;
-        if (const auto title = resolved.getPageTitle(path); !title) {
+        const auto [title, pageAttributes] =
+            co_await supplyFileIO<std::pair<std::optional<std::string>, std::optional<Frontmatter>>>(
+                [&] { return std::pair{resolved.getPageTitle(path), resolved.readPageAttributes(path)}; });
+
+        if (!title) {
             co_await issues->addIssue(ProjectIssueLevel::WARNING, ProjectIssueType::FILE, ProjectError::NO_PAGE_TITLE, "", path);
         }
 
-        const auto frontmatter = resolved.readPageAttributes(path);
-
-        if (const auto pageAttributes = resolved.readPageAttributes(path)) {
+        if (pageAttributes) {
             const std::unordered_map<std::string, std::string> attributes = {
                 {"id", pageAttributes->id}, {"title", pageAttributes->title}, {"icon", pageAttributes->icon}};
 
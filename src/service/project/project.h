@@ -130,7 +130,7 @@ namespace service {
         // Parameters
         virtual std::string getLocale() const = 0;
         // TODO Why is this never checked/called?
-        virtual bool hasLocale(const std::string &locale) const = 0;
+        virtual drogon::Task<bool> hasLocale(std::string locale) const = 0;
         virtual std::set<std::string> getLocales() const = 0;
 
         virtual drogon::Task<std::unordered_map<std::string, std::string>> getAvailableVersions() const = 0;
@@ -139,7 +139,7 @@ namespace service {
         // Pages
         virtual std::optional<std::string> getPagePath(const std::string &path) const = 0; // For project issues
         virtual std::optional<std::string> getPageTitle(const std::string &path) const = 0;
-        virtual TaskResult<ProjectPage> readPageFile(std::string path) const = 0;
+        virtual drogon::Task<TaskResult<ProjectPage>> readPageFile(std::string path) const = 0;
         virtual drogon::Task<TaskResult<ProjectPage>> readContentPage(std::string id) const = 0;
         virtual std::optional<Frontmatter> readPageAttributes(const std::string &path) const = 0;
 
@@ -160,7 +160,7 @@ namespace service {
         virtual drogon::Task<TaskResult<FileTree>> getDirectoryTree() = 0;
         virtual drogon::Task<TaskResult<FileTree>> getProjectContents() = 0;
 
-        virtual std::optional<std::filesystem::path> getAsset(const ResourceLocation &location) const = 0;
+        virtual drogon::Task<std::optional<std::filesystem::path>> getAsset(ResourceLocation location) const = 0;
         virtual drogon::Task<std::optional<content::GameRecipeType>> getRecipeType(const ResourceLocation &location) = 0;
         virtual drogon::Task<std::optional<content::ResolvedGameRecipe>> getRecipe(std::string id) = 0;
 
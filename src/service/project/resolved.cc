@@ -3,11 +3,14 @@
 #include <schemas/schemas.h>
 #include <service/database/database.h>
 #include <service/database/project_database.h>
+#include <service/file_io.h>
 #include <storage/storage.h>
 #include <service/storage/gitops.h>
 #include <service/util.h>
 
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <unordered_map>
 
 #include <fmt/args.h>
@@ -48,11 +51,13 @@ namespace service {
     }
 
     void ResolvedProject::setLocale(const std::optional<std::string> &locale) { format_.setLocale(locale); }
+    void ResolvedProject::setMetadata(const std::shared_ptr<const ProjectMetadata> &metadata) { metadata_ = metadata; }
+    void ResolvedProject::setBundle(const std::shared_ptr<const DeploymentBundle> &bundle) { bundle_ = bundle; }
     std::string ResolvedProject::getLocale() const { return format_.getLocale(); }
 
-    bool ResolvedProject::hasLocale(const std::string &locale) const {
-        const auto locales = getLocales();
-        return locales.contains(locale);
+    Task<bool> ResolvedProject::hasLocale(const std::string locale) const {
+        const auto locales = co_await supplyFileIO<std::set<std::string>>([this] { return getLocales(); });
+        co_return locales.contains(locale);
     }
 
     std::set<std::string> ResolvedProject::getLocales() const {
@@ -84,26 +89,98 @@ namespace service {
         co_return versions.contains(version);
     }
 
-    std::optional<std::filesystem::path> ResolvedProject::getAsset(const ResourceLocation &location) const {
-        if (const auto filePath = format_.getAssetsPath(location); exists(filePath)) {
-            return filePath;
+    Task<std::optional<std::filesystem::path>> ResolvedProject::getAsset(const ResourceLocation location) const {
+        co_return co_await supplyFileIO<std::optional<fs::path>>([&]() -> std::optional<fs::path> {
+            if (const auto filePath = format_.getAssetsPath(location); hasProjectFile(filePath)) {
+                return filePath;
+            }
+
+            // Legacy asset path fallback
+            if (const auto legacyFilePath =
+                    format_.getAssetsPath({.namespace_ = "item", .path_ = location.namespace_ + '/' + location.path_});
+                hasProjectFile(legacyFilePath))
+            {
+                return legacyFilePath;
+            }
+
+            return std::nullopt;
+        });
+    }
+
+    const ProjectFormat &ResolvedProject::getFormat() const { return format_; }
+
+    std::optional<std::string> ResolvedProject::getBundleKey(const fs::path &path) const {
+        if (!bundle_) {
+            return std::nullopt;
         }
+        // Bundle keys are normalized relative paths, the root itself and paths outside of it are read from disk
+        const auto relative = path.lexically_normal().lexically_relative(format_.getRoot().lexically_normal());
+        if (relative.empty() || relative == "." || *relative.begin() == "..") {
+            return std::nullopt;
+        }
+        return relative.generic_string();
+    }
 
-        // Legacy asset path fallback
-        if (const auto legacyFilePath = format_.getAssetsPath({.namespace_ = "item", .path_ = location.namespace_ + '/' + location.path_});
-            exists(legacyFilePath))
-        {
-            return legacyFilePath;
+    bool ResolvedProject::hasProjectFile(const fs::path &path) const {
+        if (const auto key = getBundleKey(path)) {
+            return bundle_->contains(*key);
+        }
+        return exists(path);
+    }
+
+    std::optional<std::string> ResolvedProject::readProjectFile(const fs::path &path) const {
+        // The bundle holds every file of the deployment, so a miss means the file does not exist
+        if (const auto key = getBundleKey(path)) {
+            if (const auto content = bundle_->read(*key)) {
+                return std::string{*content};
+            }
+            return std::nullopt;
         }
 
-        return std::nullopt;
+        std::ifstream file(path);
+        if (!file) {
+            return std::nullopt;
+        }
+
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        file.close();
+        return buffer.str();
     }
 
-    const ProjectFormat &ResolvedProject::getFormat() const { return format_; }
+    std::optional<nlohmann::json> ResolvedProject::readProjectJsonFile(const fs::path &path) const {
+        const auto key = getBundleKey(path);
+        if (!key) {
+            return parseJsonFile(path);
+        }
+
+        const auto content = bundle_->read(*key);
+        if (!content) {
+            return std::nullopt;
+        }
+        auto json = nlohmann::json::parse(*content, nullptr, false);
+        if (json.is_discarded()) {
+            logger_->error("JSON parse error in bundled file {} of project {}", *key, project_.getValueOfId());
+            return std::nullopt;
+        }
+        return json;
+    }
+
+    fs::path ResolvedProject::getLocalizedFilePath(const std::string &path) const {
+        if (!bundle_) {
+            return format_.getLocalizedFilePath(path);
+        }
+        if (getLocale() != DEFAULT_LOCALE) {
+            if (const auto localized = format_.getLocalesPath() / getLocale() / removeLeadingSlash(path); hasProjectFile(localized)) {
+                return localized;
+            }
+        }
+        return format_.getRoot() / removeLeadingSlash(path);
+    }
 
     Task<Json::Value> ResolvedProject::toJson(const bool full) const {
         const auto versions = co_await getAvailableVersions();
-        const auto locales = getLocales();
+        const auto locales = co_await supplyFileIO<std::set<std::string>>([this] { return getLocales(); });
 
         Json::Value projectJson = projectToJson(project_, full);
 
@@ -124,22 +201,23 @@ namespace service {
         }
 
         if (full) {
-            if (const auto latestDeployment = co_await global::database->getActiveDeployment(project_.getValueOfId())) {
-                if (const auto revisionStr = latestDeployment->getRevision()) {
-                    projectJson["revision"] = parseJsonOrThrow(*revisionStr);
+            // Keep the response shape when the summary is unavailable
+            projectJson["issue_stats"] = Json::Value(Json::objectValue);
+            projectJson["has_failing_deployment"] = false;
+
+            if (const auto summary = co_await global::database->getProjectSummary(project_.getValueOfId())) {
+                if (summary->revision) {
+                    projectJson["revision"] = parseJsonOrThrow(*summary->revision);
 
-                    const git::GitRevision revision = nlohmann::json::parse(*revisionStr);
+                    const git::GitRevision revision = nlohmann::json::parse(*summary->revision);
                     if (const auto url = git::formatCommitUrl(project_, revision.fullHash); !url.empty()) {
                         projectJson["revision"]["url"] = url;
                     }
                 }
-            }
-
-            const auto issueStats = co_await global::database->getActiveProjectIssueStats(project_.getValueOfId());
-            projectJson["issue_stats"] = unparkourJson(nlohmann::json(issueStats));
 
-            const auto hasFailingDeployment = co_await global::database->hasFailingDeployment(project_.getValueOfId());
-            projectJson["has_failing_deployment"] = hasFailingDeployment;
+                projectJson["issue_stats"] = unparkourJson(nlohmann::json(summary->issue_stats));
+                projectJson["has_failing_deployment"] = summary->has_failing_deployment;
+            }
         }
 
         co_return projectJson;
@@ -161,7 +239,6 @@ namespace service {
 
     Task<Json::Value> ResolvedProject::toJsonVerbose() {
         auto projectJson = co_await toJson();
-        // TODO Cache
         Json::Value infoJson;
 
         if (const auto [meta, err, detail] = validateProjectMetadata(); meta) {
@@ -186,8 +263,8 @@ namespace service {
         co_return projectJson;
     }
 
-    std::tuple<std::optional<nlohmann::json>, ProjectError, std::string> ResolvedProject::validateProjectMetadata() const {
-        const auto path = format_.getWikiMetadataPath();
+    ProjectMetadata loadProjectMetadata(const ProjectFormat &format) {
+        const auto path = format.getWikiMetadataPath();
         if (!exists(path)) {
             return {std::nullopt, ProjectError::NO_PATH, ""};
         }
@@ -209,6 +286,16 @@ namespace service {
         return {*meta, ProjectError::OK, ""};
     }
 
+    std::tuple<std::optional<nlohmann::json>, ProjectError, std::string> ResolvedProject::validateProjectMetadata() const {
+        // Deployed projects share metadata that was validated once per deployment
+        if (metadata_) {
+            return {metadata_->json, metadata_->error, metadata_->details};
+        }
+
+        const auto [json, error, details] = loadProjectMetadata(format_);
+        return {json, error, details};
+    }
+
     Task<PaginatedData<ItemContentPage>> ResolvedProject::getItemContentPages(const TableQueryParams params) const {
         const auto [total, pages, size, data] = co_await projectDb_->getProjectItemsDev(params.query, params.page);
         std::vector<ItemContentPage> itemData;
@@ -8,6 +8,7 @@
 #include <service/database/database.h>
 #include <service/project/project.h>
 #include <service/project/format.h>
+#include <service/storage/bundle.h>
 #include <service/storage/issues/issue_callback.h>
 #include <service/util.h>
 
@@ -23,9 +24,13 @@ namespace service {
     };
 
     struct ProjectMetadata {
-        Json::Value platforms;
+        std::optional<nlohmann::json> json;
+        ProjectError error;
+        std::string details;
     };
 
+    ProjectMetadata loadProjectMetadata(const ProjectFormat &format);
+
     struct ProjectErrorInstance {
         ProjectError error;
         std::string message;
@@ -45,9 +50,11 @@ namespace service {
         // Parameters
         void setDefaultVersion(const ResolvedProject &defaultVersion);
         void setLocale(const std::optional<std::string> &locale);
+        void setMetadata(const std::shared_ptr<const ProjectMetadata> &metadata);
+        void setBundle(const std::shared_ptr<const DeploymentBundle> &bundle);
 
         std::string getLocale() const override;
-        bool hasLocale(const std::string &locale) const override;
+        drogon::Task<bool> hasLocale(std::string locale) const override;
         std::set<std::string> getLocales() const override;
 
         drogon::Task<std::unordered_map<std::string, std::string>> getAvailableVersions() const override;
@@ -56,7 +63,7 @@ namespace service {
         // Pages
         std::optional<std::string> getPagePath(const std::string &path) const override;
         std::optional<std::string> getPageTitle(const std::string &path) const override;
-        TaskResult<ProjectPage> readPageFile(std::string path) const override;
+        drogon::Task<TaskResult<ProjectPage>> readPageFile(std::string path) const override;
         drogon::Task<TaskResult<ProjectPage>> readContentPage(std::string id) const override;
         std::optional<Frontmatter> readPageAttributes(const std::string &path) const override;
 
@@ -77,10 +84,13 @@ namespace service {
         drogon::Task<TaskResult<FileTree>> getDirectoryTree() override;
         drogon::Task<TaskResult<FileTree>> getProjectContents() override;
 
-        std::optional<std::filesystem::path> getAsset(const ResourceLocation &location) const override;
+        drogon::Task<std::optional<std::filesystem::path>> getAsset(ResourceLocation location) const override;
         drogon::Task<std::optional<content::GameRecipeType>> getRecipeType(const ResourceLocation &location) override;
         drogon::Task<std::optional<content::ResolvedGameRecipe>> getRecipe(std::string id) override;
 
+        // Indexing
+        Error writeTreeIndex() const;
+
         // Validation
         drogon::Task<> validatePages();
         std::tuple<std::optional<nlohmann::json>, ProjectError, std::string> validateProjectMetadata() const;
@@ -96,10 +106,23 @@ namespace service {
         FolderMetadata getFolderMetadata(const std::filesystem::path &path) const;
         FileTree getDirectoryTree(const std::filesystem::path &dir) const;
         void addPageMetadata(FileTree &tree) const;
+        TaskResult<FileTree> computeProjectContents() const;
+
+        bool hasTreeIndex() const;
+        TaskResult<FileTree> readTreeIndex(const std::string &name) const;
+
+        // File access that goes through the deployment bundle when one is attached
+        std::optional<std::string> getBundleKey(const std::filesystem::path &path) const;
+        bool hasProjectFile(const std::filesystem::path &path) const;
+        std::optional<std::string> readProjectFile(const std::filesystem::path &path) const;
+        std::optional<nlohmann::json> readProjectJsonFile(const std::filesystem::path &path) const;
+        std::filesystem::path getLocalizedFilePath(const std::string &path) const;
 
         Project project_;
         V0ProjectFormat format_;
         std::shared_ptr<ResolvedProject> defaultVersion_;
+        std::shared_ptr<const ProjectMetadata> metadata_;
+        std::shared_ptr<const DeploymentBundle> bundle_;
         ProjectVersion version_;
         std::shared_ptr<ProjectDatabaseAccess> projectDb_;
         std::shared_ptr<ProjectIssueCallback> issues_;
@@ -39,7 +39,7 @@ namespace service {
 
     // Locales TODO
     std::string VirtualProject::getLocale() const { return DEFAULT_LOCALE; }
-    bool VirtualProject::hasLocale(const std::string &locale) const { return locale == DEFAULT_LOCALE; }
+    Task<bool> VirtualProject::hasLocale(const std::string locale) const { co_return locale == DEFAULT_LOCALE; }
     std::set<std::string> VirtualProject::getLocales() const { return {DEFAULT_LOCALE}; }
 
     // Versions
@@ -49,7 +49,7 @@ namespace service {
     // Pages
     std::optional<std::string> VirtualProject::getPagePath(const std::string &path) const { return std::nullopt; }
     std::optional<std::string> VirtualProject::getPageTitle(const std::string &path) const { return std::nullopt; }
-    TaskResult<ProjectPage> VirtualProject::readPageFile(std::string path) const { return Error::ErrNotFound; }
+    Task<TaskResult<ProjectPage>> VirtualProject::readPageFile(std::string path) const { co_return Error::ErrNotFound; }
     Task<TaskResult<ProjectPage>> VirtualProject::readContentPage(std::string id) const { co_return Error::ErrNotFound; }
     std::optional<Frontmatter> VirtualProject::readPageAttributes(const std::string &path) const { return std::nullopt; }
 
@@ -88,8 +88,8 @@ namespace service {
         co_return co_await global::lang->getItemName(std::nullopt, location);
     }
 
-    std::optional<std::filesystem::path> VirtualProject::getAsset(const ResourceLocation &location) const {
-        return std::nullopt; // TODO
+    Task<std::optional<std::filesystem::path>> VirtualProject::getAsset(ResourceLocation location) const {
+        co_return std::nullopt; // TODO
     }
 
     Task<std::optional<content::GameRecipeType>> VirtualProject::getRecipeType(const ResourceLocation &location) { co_return std::nullopt; }
@@ -23,7 +23,7 @@ namespace service {
 
         // Parameters
         std::string getLocale() const override;
-        bool hasLocale(const std::string &locale) const override;
+        drogon::Task<bool> hasLocale(std::string locale) const override;
         std::set<std::string> getLocales() const override;
 
         drogon::Task<std::unordered_map<std::string, std::string>> getAvailableVersions() const override;
@@ -32,7 +32,7 @@ namespace service {
         // Pages
         std::optional<std::string> getPagePath(const std::string &path) const override;
         std::optional<std::string> getPageTitle(const std::string &path) const override;
-        TaskResult<ProjectPage> readPageFile(std::string path) const override;
+        drogon::Task<TaskResult<ProjectPage>> readPageFile(std::string path) const override;
         drogon::Task<TaskResult<ProjectPage>> readContentPage(std::string id) const override;
         std::optional<Frontmatter> readPageAttributes(const std::string &path) const override;
 
@@ -53,7 +53,7 @@ namespace service {
         drogon::Task<TaskResult<FileTree>> getDirectoryTree() override;
         drogon::Task<TaskResult<FileTree>> getProjectContents() override;
 
-        std::optional<std::filesystem::path> getAsset(const ResourceLocation &location) const override;
+        drogon::Task<std::optional<std::filesystem::path>> getAsset(ResourceLocation location) const override;
         drogon::Task<std::optional<content::GameRecipeType>> getRecipeType(const ResourceLocation &location) override;
         drogon::Task<std::optional<content::ResolvedGameRecipe>> getRecipe(std::string id) override;
 
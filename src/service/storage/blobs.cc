@@ -0,0 +1,134 @@
+#include "blobs.h"
+
+#include <format>
+#include <git2/odb.h>
+#include <git2/oid.h>
+#include <log/log.h>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace logging;
+namespace fs = std::filesystem;
+
+namespace service {
+    void copyFileFast(const fs::path &source, const fs::path &dest) {
+#ifdef __linux__
+        if (const int in = open(source.c_str(), O_RDONLY | O_CLOEXEC); in >= 0) {
+            bool done = false;
+
+            struct stat st{};
+            if (fstat(in, &st) == 0) {
+                if (const int out = open(dest.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 0777); out >= 0) {
+                    // Share extents on copy-on-write filesystems
+                    done = ioctl(out, FICLONE, in) == 0;
+
+                    // Otherwise copy inside the kernel without going through user space
+                    if (!done) {
+                        done = true;
+                        for (off_t remaining = st.st_size; remaining > 0;) {
+                            const auto copied = copy_file_range(in, nullptr, out, nullptr, remaining, 0);
+                            if (copied < 0) {
+                                done = false;
+                                break;
+                            }
+                            if (copied == 0) {
+                                break;
+                            }
+                            remaining -= copied;
+                        }
+                    }
+
+                    close(out);
+                }
+            }
+
+            close(in);
+            if (done) {
+                return;
+            }
+        }
+#endif
+        copy_file(source, dest, fs::copy_options::overwrite_existing);
+    }
+
+    BlobStore::BlobStore(const fs::path &root) : root_(root) { create_directories(root_); }
+
+    std::optional<fs::path> BlobStore::store(const fs::path &file) const {
+        git_oid oid;
+        if (git_odb_hash_file(&oid, file.c_str(), GIT_OBJECT_BLOB) != 0) {
+            return std::nullopt;
+        }
+
+        char hash[GIT_OID_HEXSZ + 1] = {};
+        git_oid_fmt(hash, &oid);
+        const std::string hashStr{hash};
+
+        const auto blobDir = root_ / hashStr.substr(0, 2);
+        const auto blob = blobDir / hashStr;
+        if (exists(blob)) {
+            return blob;
+        }
+
+        // Publish the blob atomically, concurrent writers of the same content keep the first copy
+        create_directories(blobDir);
+        const auto tmp = blobDir / std::format(".{}-{}", hashStr, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        copyFileFast(file, tmp);
+
+        std::error_code ec;
+        create_hard_link(tmp, blob, ec);
+        remove(tmp);
+        if (ec && !exists(blob)) {
+            return std::nullopt;
+        }
+
+        return blob;
+    }
+
+    bool BlobStore::link(const fs::path &file, const fs::path &dest) const {
+        // Retry once in case the blob was garbage collected in between
+        for (int attempt = 0; attempt < 2; attempt++) {
+            const auto blob = store(file);
+            if (!blob) {
+                return false;
+            }
+
+            std::error_code ec;
+            create_hard_link(*blob, dest, ec);
+            if (!ec) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t BlobStore::collectGarbage() const {
+        size_t removed = 0;
+
+        try {
+            for (const auto &entry: fs::recursive_directory_iterator(root_)) {
+                std::error_code ec;
+                // Only referenced by the store itself
+                if (entry.is_regular_file(ec) && entry.hard_link_count(ec) == 1 && !ec) {
+                    if (remove(entry.path(), ec)) {
+                        removed++;
+                    }
+                }
+            }
+        } catch (std::exception &e) {
+            logger.error("Error collecting unused blobs: {}", e.what());
+        }
+
+        if (removed > 0) {
+            logger.debug("Removed {} unused blobs", removed);
+        }
+
+        return removed;
+    }
+}
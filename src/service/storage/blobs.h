@@ -0,0 +1,24 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+
+namespace service {
+    // Copy a file using reflinks or in-kernel copies where the filesystem supports them
+    void copyFileFast(const std::filesystem::path &source, const std::filesystem::path &dest);
+
+    // Content-addressed file store shared by all deployments.
+    // Deployment files are hardlinks to blobs, so a blob's link count doubles as its reference count.
+    class BlobStore {
+    public:
+        explicit BlobStore(const std::filesystem::path &root);
+
+        std::optional<std::filesystem::path> store(const std::filesystem::path &file) const;
+        bool link(const std::filesystem::path &file, const std::filesystem::path &dest) const;
+
+        size_t collectGarbage() const;
+
+    private:
+        const std::filesystem::path root_;
+    };
+}
@@ -0,0 +1,293 @@
+#include "bundle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <log/log.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#define BUNDLE_MAGIC "PWBUNDLE"
+#define BUNDLE_VERSION 1
+#define BUNDLE_EXT ".bundle"
+// Maximum attempts at placing a single bucket before the table is grown
+#define MAX_BUCKET_SEED 1000000
+#define MAX_TABLE_ATTEMPTS 8
+
+using namespace logging;
+namespace fs = std::filesystem;
+
+namespace service {
+    struct BundleHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t bucketCount;
+        uint32_t slotCount;
+        uint64_t namesOffset;
+        uint64_t seedsOffset;
+        uint64_t entriesOffset;
+    };
+
+    // Unused slots have an empty name, which no file can have
+    struct BundleEntry {
+        uint64_t dataOffset;
+        uint64_t dataSize;
+        uint64_t nameOffset;
+        uint32_t nameSize;
+        uint32_t reserved;
+    };
+
+    uint64_t hashPath(const std::string_view path, const uint64_t seed) {
+        uint64_t hash = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+        for (const unsigned char c: path) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        // Mix the result so that consecutive seeds produce unrelated slots
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    // Hash and displace: keys are grouped into buckets by one hash, then every bucket gets a seed that sends all of its
+    // keys to free slots. Large buckets are placed first while the table is still empty.
+    std::optional<std::vector<uint32_t>> findBucketSeeds(const std::vector<std::string> &keys, const uint32_t bucketCount,
+                                                         const uint32_t slotCount, std::vector<uint32_t> &slots) {
+        std::vector<std::vector<uint32_t>> buckets(bucketCount);
+        for (uint32_t i = 0; i < keys.size(); i++) {
+            buckets[hashPath(keys[i], 0) % bucketCount].push_back(i);
+        }
+
+        std::vector<uint32_t> order(bucketCount);
+        for (uint32_t i = 0; i < bucketCount; i++) {
+            order[i] = i;
+        }
+        std::ranges::stable_sort(order, [&](const uint32_t a, const uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        std::vector<uint32_t> seeds(bucketCount, 0);
+        std::vector<bool> taken(slotCount, false);
+        slots.assign(keys.size(), 0);
+
+        std::vector<uint32_t> candidate;
+        for (const auto bucket: order) {
+            const auto &members = buckets[bucket];
+            if (members.empty()) {
+                break;
+            }
+
+            bool placed = false;
+            for (uint32_t seed = 1; seed <= MAX_BUCKET_SEED && !placed; seed++) {
+                candidate.clear();
+                placed = true;
+                for (const auto key: members) {
+                    const auto slot = static_cast<uint32_t>(hashPath(keys[key], seed) % slotCount);
+                    if (taken[slot] || std::ranges::find(candidate, slot) != candidate.end()) {
+                        placed = false;
+                        break;
+                    }
+                    candidate.push_back(slot);
+                }
+                if (placed) {
+                    seeds[bucket] = seed;
+                    for (size_t i = 0; i < members.size(); i++) {
+                        taken[candidate[i]] = true;
+                        slots[members[i]] = candidate[i];
+                    }
+                }
+            }
+            if (!placed) {
+                return std::nullopt;
+            }
+        }
+
+        return seeds;
+    }
+
+    void writePadding(std::ofstream &out, const size_t alignment) {
+        static constexpr char zeroes[8] = {};
+        if (const auto remainder = static_cast<size_t>(out.tellp()) % alignment; remainder != 0) {
+            out.write(zeroes, static_cast<std::streamsize>(alignment - remainder));
+        }
+    }
+
+    // Stored next to the directory it was packed from
+    fs::path DeploymentBundle::getPath(const fs::path &root) { return fs::path(root.string() + BUNDLE_EXT); }
+
+    Error DeploymentBundle::write(const fs::path &root, const fs::path &file) {
+        std::vector<std::string> keys;
+        try {
+            for (const auto &entry: fs::recursive_directory_iterator(root)) {
+                if (entry.is_regular_file()) {
+                    keys.push_back(relative(entry.path(), root).generic_string());
+                }
+            }
+        } catch (std::exception &e) {
+            logger.error("Error listing files for bundle at {}: {}", root.string(), e.what());
+            return Error::ErrInternal;
+        }
+        std::ranges::sort(keys);
+
+        const auto bucketCount = static_cast<uint32_t>(keys.size() / 4 + 1);
+        auto slotCount = static_cast<uint32_t>(keys.size() + keys.size() / 8 + 1);
+        std::vector<uint32_t> slots;
+        std::optional<std::vector<uint32_t>> seeds;
+        for (int attempt = 0; attempt < MAX_TABLE_ATTEMPTS && !seeds; attempt++) {
+            seeds = findBucketSeeds(keys, bucketCount, slotCount, slots);
+            if (!seeds) {
+                slotCount += slotCount / 4 + 1;
+            }
+        }
+        if (!seeds) {
+            logger.error("Failed to build bundle index for {} files", keys.size());
+            return Error::ErrInternal;
+        }
+
+        const auto tmp = fs::path(file.string() + ".tmp");
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return Error::ErrInternal;
+        }
+
+        BundleHeader header{};
+        std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(header.magic));
+        header.version = BUNDLE_VERSION;
+        header.entryCount = static_cast<uint32_t>(keys.size());
+        header.bucketCount = bucketCount;
+        header.slotCount = slotCount;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        std::vector<BundleEntry> entries(slotCount, BundleEntry{});
+        for (size_t i = 0; i < keys.size(); i++) {
+            writePadding(out, 8);
+            auto &entry = entries[slots[i]];
+            entry.dataOffset = out.tellp();
+
+            std::ifstream in(root / keys[i], std::ios::binary);
+            if (!in) {
+                logger.error("Failed to read {} while writing bundle", keys[i]);
+                out.close();
+                std::error_code ec;
+                remove(tmp, ec);
+                return Error::ErrInternal;
+            }
+            if (in.peek() != std::ifstream::traits_type::eof()) {
+                out << in.rdbuf();
+            }
+            entry.dataSize = static_cast<uint64_t>(out.tellp()) - entry.dataOffset;
+        }
+
+        header.namesOffset = out.tellp();
+        for (size_t i = 0; i < keys.size(); i++) {
+            auto &entry = entries[slots[i]];
+            entry.nameOffset = static_cast<uint64_t>(out.tellp()) - header.namesOffset;
+            entry.nameSize = static_cast<uint32_t>(keys[i].size());
+            out.write(keys[i].data(), static_cast<std::streamsize>(keys[i].size()));
+        }
+
+        writePadding(out, 8);
+        header.seedsOffset = out.tellp();
+        out.write(reinterpret_cast<const char *>(seeds->data()), static_cast<std::streamsize>(seeds->size() * sizeof(uint32_t)));
+
+        writePadding(out, 8);
+        header.entriesOffset = out.tellp();
+        out.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(BundleEntry)));
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.close();
+        if (!out) {
+            logger.error("Failed to write bundle {}", file.string());
+            return Error::ErrInternal;
+        }
+
+        std::error_code ec;
+        fs::rename(tmp, file, ec);
+        if (ec) {
+            remove(tmp, ec);
+            return Error::ErrInternal;
+        }
+
+        return Error::Ok;
+    }
+
+    std::shared_ptr<const DeploymentBundle> DeploymentBundle::open(const fs::path &file) {
+        const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(BundleHeader)) {
+            close(fd);
+            return nullptr;
+        }
+
+        const auto size = static_cast<size_t>(st.st_size);
+        void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        // The mapping stays valid after the descriptor is closed, and after the file is moved to the trash
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            return nullptr;
+        }
+        madvise(mapped, size, MADV_RANDOM);
+
+        const auto data = static_cast<const char *>(mapped);
+        const auto header = reinterpret_cast<const BundleHeader *>(data);
+        const auto seedsEnd = header->seedsOffset + static_cast<uint64_t>(header->bucketCount) * sizeof(uint32_t);
+        const auto entriesEnd = header->entriesOffset + static_cast<uint64_t>(header->slotCount) * sizeof(BundleEntry);
+        if (std::memcmp(header->magic, BUNDLE_MAGIC, sizeof(header->magic)) != 0 || header->version != BUNDLE_VERSION ||
+            header->bucketCount == 0 || header->slotCount == 0 || seedsEnd > size || entriesEnd > size || header->namesOffset > size)
+        {
+            logger.error("Invalid deployment bundle {}", file.string());
+            munmap(mapped, size);
+            return nullptr;
+        }
+
+        return std::shared_ptr<const DeploymentBundle>(new DeploymentBundle(data, size));
+    }
+
+    DeploymentBundle::DeploymentBundle(const char *data, const size_t size) :
+        data_(data), size_(size), header_(reinterpret_cast<const BundleHeader *>(data)),
+        seeds_(reinterpret_cast<const uint32_t *>(data + header_->seedsOffset)),
+        entries_(reinterpret_cast<const BundleEntry *>(data + header_->entriesOffset)) {}
+
+    DeploymentBundle::~DeploymentBundle() { munmap(const_cast<char *>(data_), size_); }
+
+    const BundleEntry *DeploymentBundle::find(const std::string_view path) const {
+        if (path.empty()) {
+            return nullptr;
+        }
+
+        const auto bucket = hashPath(path, 0) % header_->bucketCount;
+        const auto slot = hashPath(path, seeds_[bucket]) % header_->slotCount;
+
+        const auto entry = &entries_[slot];
+        if (entry->nameSize != path.size() || header_->namesOffset + entry->nameOffset + entry->nameSize > size_ ||
+            entry->dataOffset + entry->dataSize > size_)
+        {
+            return nullptr;
+        }
+        if (std::memcmp(data_ + header_->namesOffset + entry->nameOffset, path.data(), path.size()) != 0) {
+            return nullptr;
+        }
+        return entry;
+    }
+
+    std::optional<std::string_view> DeploymentBundle::read(const std::string_view path) const {
+        if (const auto entry = find(path)) {
+            return std::string_view{data_ + entry->dataOffset, entry->dataSize};
+        }
+        return std::nullopt;
+    }
+
+    bool DeploymentBundle::contains(const std::string_view path) const { return find(path) != nullptr; }
+
+    size_t DeploymentBundle::size() const { return header_->entryCount; }
+}
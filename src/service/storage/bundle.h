@@ -0,0 +1,41 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <service/error.h>
+#include <string_view>
+
+namespace service {
+    struct BundleHeader;
+    struct BundleEntry;
+
+    // Single file image of a deployment version directory, memory-mapped read-only.
+    // Files are located through a perfect hash over their relative paths, so a lookup is a couple of hash computations
+    // and a key comparison instead of filesystem calls.
+    class DeploymentBundle {
+    public:
+        ~DeploymentBundle();
+        DeploymentBundle(const DeploymentBundle &) = delete;
+        DeploymentBundle &operator=(const DeploymentBundle &) = delete;
+
+        static std::filesystem::path getPath(const std::filesystem::path &root);
+        static Error write(const std::filesystem::path &root, const std::filesystem::path &file);
+        static std::shared_ptr<const DeploymentBundle> open(const std::filesystem::path &file);
+
+        std::optional<std::string_view> read(std::string_view path) const;
+        bool contains(std::string_view path) const;
+        size_t size() const;
+
+    private:
+        DeploymentBundle(const char *data, size_t size);
+
+        const BundleEntry *find(std::string_view path) const;
+
+        const char *data_;
+        const size_t size_;
+        const BundleHeader *header_;
+        const uint32_t *seeds_;
+        const BundleEntry *entries_;
+    };
+}
@@ -3,11 +3,14 @@
 #include <git2/repository.h>
 #include <service/storage/ingestor/ingestor.h>
 #include <service/database/project_database.h>
+#include <service/parallel.h>
 #include <service/storage/deployment.h>
 #include <service/storage/gitops.h>
 #include <service/util.h>
+#include <sys/resource.h>
 
 #define TEMP_DIR ".temp"
+#define MAX_PARALLEL_VERSIONS 4
 
 using namespace logging;
 using namespace drogon;
@@ -16,12 +19,28 @@ namespace fs = std::filesystem;
 
 const std::set<std::string> allowedFileExtensions = {".mdx", ".json", ".png", ".jpg", ".jpeg", ".webp", ".gif"};
 
-Error copyProjectFiles(const fs::path &docsRoot, const fs::path &dest, const std::shared_ptr<spdlog::logger> &projectLog) {
+struct service::DeploymentChanges {
+    fs::path previousRoot;
+    git::GitChangeSet files;
+    bool reingest;
+};
+
+int64_t service::getPeakMemoryKb() {
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    // Reported in kilobytes on Linux
+    return usage.ru_maxrss;
+}
+
+Error service::copyProjectFiles(const fs::path &docsRoot, const fs::path &dest, const BlobStore &blobs, CopyCounters &counters,
+                                const std::shared_ptr<spdlog::logger> &projectLog, const DeploymentChanges *changes) {
     projectLog->info("Copying project files for version '{}'", dest.filename().string());
 
+    std::vector<fs::path> files;
     try {
-        create_directories(dest);
-
+        std::set<fs::path> directories;
         for (const auto &entry: fs::recursive_directory_iterator(docsRoot)) {
             if (!entry.is_regular_file()) {
                 continue;
@@ -33,29 +52,170 @@ Error copyProjectFiles(const fs::path &docsRoot, const fs::path &dest, const std
                 continue;
             }
 
-            if (fs::path destination_path = dest / relative_path.parent_path(); !exists(destination_path)) {
-                create_directories(destination_path);
-            }
+            directories.insert(relative_path.parent_path());
+            files.push_back(relative_path);
+        }
 
-            copy(entry, dest / relative_path, fs::copy_options::overwrite_existing);
+        // Create the directory tree up front so that copy workers never race on it
+        create_directories(dest);
+        for (const auto &directory: directories) {
+            create_directories(dest / directory);
         }
     } catch (std::exception &e) {
         projectLog->error("FS copy error: {}", e.what());
         return Error::ErrInternal;
     }
 
-    projectLog->info("Done copying files");
+    std::atomic<size_t> linked{0};
+    try {
+        parallelFor(files.size(), [&](const size_t i) {
+            const auto &relative_path = files[i];
+
+            // Unchanged files are shared with the previous deployment
+            if (changes && !changes->files.changed.contains(relative_path.generic_string())) {
+                std::error_code ec;
+                if (const auto previous = changes->previousRoot / relative_path; exists(previous, ec)) {
+                    create_hard_link(previous, dest / relative_path, ec);
+                    if (!ec) {
+                        linked++;
+                        return;
+                    }
+                }
+            }
+
+            // Identical files across versions and deployments share a single blob
+            if (!blobs.link(docsRoot / relative_path, dest / relative_path)) {
+                copyFileFast(docsRoot / relative_path, dest / relative_path);
+            }
+        });
+    } catch (std::exception &e) {
+        projectLog->error("FS copy error: {}", e.what());
+        return Error::ErrInternal;
+    }
+
+    counters.copied += static_cast<int64_t>(files.size() - linked.load());
+    counters.reused += static_cast<int64_t>(linked.load());
+
+    if (linked > 0) {
+        projectLog->info("Done copying {} files, reused {} unchanged files", files.size(), linked.load());
+    } else {
+        projectLog->info("Done copying {} files", files.size());
+    }
 
     return Error::Ok;
 }
 
+void writeTreeIndex(const Project &project, const ProjectVersion &version, const fs::path &root,
+                    const std::shared_ptr<spdlog::logger> &projectLog) {
+    projectLog->info("Writing tree index for version '{}'", root.filename().string());
+
+    // Page issues have already been reported while validating the clone
+    const auto issues = std::make_shared<ProjectIssueCallback>("", projectLog);
+    const ResolvedProject resolved{project, root, version, issues, projectLog};
+    if (const auto error = resolved.writeTreeIndex(); error != Error::Ok) {
+        projectLog->warn("Failed to write tree index, trees will be computed on demand");
+    }
+}
+
+void writeBundle(const fs::path &root, const std::shared_ptr<spdlog::logger> &projectLog) {
+    projectLog->info("Writing bundle for version '{}'", root.filename().string());
+
+    if (DeploymentBundle::write(root, DeploymentBundle::getPath(root)) != Error::Ok) {
+        projectLog->warn("Failed to write bundle, files will be read from disk");
+    }
+}
+
+bool isIngestedFileChange(const ResolvedProject &previous, const ResolvedProject &current, const std::string &path) {
+    // Tags, recipes and other game data
+    if (const auto dataDir = relative(current.getFormat().getDataRoot(), current.getFormat().getRoot()).generic_string() + "/";
+        path.starts_with(dataDir))
+    {
+        return true;
+    }
+
+    // Pages are only ingested through their item id
+    if (fs::path(path).extension() == DOCS_FILE_EXT) {
+        const auto previousAttributes = previous.readPageAttributes(path);
+        const auto currentAttributes = current.readPageAttributes(path);
+        return (previousAttributes ? previousAttributes->id : "") != (currentAttributes ? currentAttributes->id : "");
+    }
+
+    return false;
+}
+
+struct VersionCheckout {
+    ProjectVersion version;
+    std::string treeish;
+    fs::path checkoutDir;
+    fs::path dest;
+};
+
+// Check out and copy every version in parallel on the deployment threads, which their file copies share as well. Each
+// version opens its own handle on the clone's object store, since libgit2 repositories must not be shared between threads.
+// Returns the result of each checkout.
+std::vector<Error> materializeVersions(const Project &project, const fs::path &clonePath, const std::vector<VersionCheckout> &checkouts,
+                                      const BlobStore &blobs, CopyCounters &counters, const bool bundle,
+                                      const std::shared_ptr<spdlog::logger> &logger) {
+    std::vector results(checkouts.size(), Error::ErrInternal);
+    parallelFor(
+        checkouts.size(),
+        [&](const size_t i) {
+            const auto &[version, treeish, checkoutDir, dest] = checkouts[i];
+            logger->info("Setting up version '{}' on branch '{}'", version.getValueOfName(), version.getValueOfBranch());
+
+            git_repository *repo = nullptr;
+            if (git_repository_open(&repo, absolute(clonePath).c_str()) != 0) {
+                logger->error("Failed to open repository: {}", clonePath.string());
+                return;
+            }
+            const std::unique_ptr<git_repository, decltype(&git_repository_free)> repoGuard{repo, git_repository_free};
+
+            try {
+                remove_all(checkoutDir);
+                if (git::checkoutTree(repo, treeish, checkoutDir, project.getValueOfSourcePath(), logger) != Error::Ok) {
+                    logger->error("Failed to check out version '{}'", version.getValueOfName());
+                } else if (copyProjectFiles(checkoutDir / removeLeadingSlash(project.getValueOfSourcePath()), dest, blobs, counters,
+                                            logger) != Error::Ok)
+                {
+                    logger->error("Failed to copy files of version '{}'", version.getValueOfName());
+                } else {
+                    writeTreeIndex(project, version, dest, logger);
+                    if (bundle) {
+                        writeBundle(dest, logger);
+                    }
+                    results[i] = Error::Ok;
+                }
+                remove_all(checkoutDir);
+            } catch (std::exception &e) {
+                logger->error("Failed to set up version '{}': {}", version.getValueOfName(), e.what());
+            }
+        },
+        MAX_PARALLEL_VERSIONS);
+
+    return results;
+}
+
+// Run blocking git and filesystem work on the deployment worker. Fast database clients belong to the IO loop they were
+// created on, so the deployment returns to its IO loop before the next query.
+template<class T>
+Task<T> runOnWorker(trantor::EventLoop *workerLoop, std::function<T()> task) {
+    if (!workerLoop) {
+        co_return co_await supplyDeploymentWork<T>(std::move(task));
+    }
+    const auto currentLoop = trantor::EventLoop::getEventLoopOfCurrentThread();
+    const auto result = co_await queueInLoopCoro<T>(workerLoop, std::move(task));
+    co_await switchThreadCoro(currentLoop);
+    co_return result;
+}
+
 namespace service {
     // clang-format off
     DEFINE_ENUM(DeploymentStatus,
         {DeploymentStatus::CREATED, "created"},
         {DeploymentStatus::LOADING, "loading"},
         {DeploymentStatus::SUCCESS, "success"},
-        {DeploymentStatus::ERROR, "error"}
+        {DeploymentStatus::ERROR, "error"},
+        {DeploymentStatus::CANCELLED, "cancelled"}
     )
     // clang-format on
 
@@ -131,23 +291,74 @@ namespace service {
         co_return co_await global::database->createProjectVersion(defaultVersion);
     }
 
-    Task<TaskResult<>> setActiveDeployment(const std::string projectId, Deployment &deployment) {
-        co_return co_await executeTransaction([projectId, &deployment](const Database &client) -> Task<> {
+    Task<TaskResult<>> setActiveDeployment(const std::string projectId, Deployment &deployment,
+                                           const std::optional<ProjectVersion> &stagingVersion) {
+        co_return co_await executeTransaction([projectId, &deployment, &stagingVersion](const Database &client) -> Task<> {
             if (const auto result = co_await client.deactivateDeployments(projectId); !result) {
                 throw orm::Failure("Deployment deactivation failed");
             }
 
+            // Newly ingested content becomes visible together with the deployment's files
+            if (stagingVersion) {
+                if (const auto result = co_await client.activateStagingVersion(projectId, stagingVersion->getValueOfId()); !result) {
+                    throw orm::Failure("Staging version activation failed");
+                }
+            }
+
+            // Readers only resolve successful deployments, so the status must be committed together with the flag
+            deployment.setStatus(enumToStr(DeploymentStatus::SUCCESS));
             deployment.setActive(true);
             co_await client.updateModel(deployment);
         });
     }
 
+    std::optional<DeploymentChanges> getDeploymentChanges(git_repository *repo, const ResolvedProject &current,
+                                                          const ResolvedProject &previous, const Deployment &previousDeployment,
+                                                          const git::GitRevision &revision, const std::shared_ptr<spdlog::logger> &logger) {
+        const auto &project = current.getProject();
+        if (previousDeployment.getValueOfSourceRepo() != project.getValueOfSourceRepo() ||
+            previousDeployment.getValueOfSourceBranch() != project.getValueOfSourceBranch() ||
+            previousDeployment.getValueOfSourcePath() != project.getValueOfSourcePath())
+        {
+            logger->info("Project source changed since the active deployment, performing full deployment");
+            return std::nullopt;
+        }
+
+        const auto previousRoot = previous.getFormat().getRoot();
+        if (!previousDeployment.getRevision() || !exists(previousRoot)) {
+            return std::nullopt;
+        }
+
+        const git::GitRevision previousRevision = nlohmann::json::parse(*previousDeployment.getRevision());
+        if (git::fetchRevision(repo, previousRevision.fullHash, logger) != Error::Ok) {
+            logger->info("Active deployment revision is not available, performing full deployment");
+            return std::nullopt;
+        }
+
+        const auto files = git::diffRevisions(repo, previousRevision.fullHash, revision.fullHash, project.getValueOfSourcePath());
+        if (!files) {
+            logger->info("Failed to compare revisions, performing full deployment");
+            return std::nullopt;
+        }
+
+        const auto isIngested = [&](const std::string &path) { return isIngestedFileChange(previous, current, path); };
+        const auto reingest = std::ranges::any_of(files->changed, isIngested) || std::ranges::any_of(files->deleted, isIngested);
+        const DeploymentChanges changes{.previousRoot = previousRoot, .files = *files, .reingest = reingest};
+
+        logger->info("Deploying incrementally from revision {}: {} changed, {} deleted files", previousRevision.hash,
+                     files->changed.size(), files->deleted.size());
+        return changes;
+    }
+
     Task<TaskResult<ProjectVersion>> Storage::getDefaultVersion(const Project &project) const {
         co_return co_await global::database->getDefaultProjectVersion(project.getValueOfId());
     }
 
-    Task<ProjectError> Storage::deployProject(const Project &project, Deployment &deployment, const fs::path clonePath) const {
+    Task<ProjectError> Storage::deployProject(const Project &project, Deployment &deployment, const fs::path clonePath,
+                                              const std::optional<Deployment> previous, trantor::EventLoop *workerLoop,
+                                              DeploymentMetrics &metrics) const {
         const auto logger = getDeploymentLogger(deployment);
+        StageTimer timer{&metrics};
         logger->info("Setting up project");
 
         deployment.setStatus(enumToStr(DeploymentStatus::LOADING));
@@ -156,12 +367,24 @@ namespace service {
         const auto issues = std::make_shared<ProjectIssueCallback>(deployment.getValueOfId(), logger);
 
         // 1. Clone repository
-        const auto [repo, cloneError] =
-            co_await git::cloneRepository(project.getValueOfSourceRepo(), clonePath, project.getValueOfSourceBranch(), logger);
+        timer.begin("clone");
+        size_t bytesCloned = 0;
+        const auto cloned = co_await runOnWorker<std::tuple<git_repository *, ProjectErrorInstance>>(workerLoop, [&] {
+            return mirrors_.cloneRepository(project.getValueOfSourceRepo(), clonePath, project.getValueOfSourceBranch(),
+                                            project.getValueOfSourcePath(), logger, &bytesCloned);
+        });
+        // Freed on every return, the copy stage releases it early
+        std::unique_ptr<git_repository, decltype(&git_repository_free)> repo{std::get<0>(cloned), git_repository_free};
+        const auto &cloneError = std::get<1>(cloned);
+        metrics.bytes_cloned = static_cast<int64_t>(bytesCloned);
         if (!repo || cloneError.error != ProjectError::OK) {
             co_await issues->addIssue(ProjectIssueLevel::ERROR, ProjectIssueType::GIT_CLONE, cloneError.error, cloneError.message);
             co_return cloneError.error;
         }
+        if (isDeploymentCancelled(project)) {
+            logger->info("Deployment superseded by a newer push, cancelling");
+            co_return ProjectError::CANCELLED;
+        }
 
         // 2. Create default version if not exists
         auto defaultVersion = co_await getDefaultVersion(project);
@@ -176,7 +399,7 @@ namespace service {
         }
 
         // 3. Assign revision info to deployment
-        const auto revision = git::getLatestRevision(repo);
+        const auto revision = git::getLatestRevision(repo.get());
         if (!revision) {
             logger->error("Error getting commit information");
             co_await issues->addIssue(ProjectIssueLevel::ERROR, ProjectIssueType::GIT_INFO, ProjectError::UNKNOWN);
@@ -191,25 +414,72 @@ namespace service {
         ResolvedProject resolved{project, cloneDocsRoot, *defaultVersion, issues, projectLog};
 
         // 5. Validate metadata
-        if (const auto [c, e, details] = resolved.validateProjectMetadata(); !details.empty()) {
+        timer.begin("validate_metadata");
+        if (const auto [c, e, details] =
+                co_await runOnWorker<std::tuple<std::optional<nlohmann::json>, ProjectError, std::string>>(
+                    workerLoop, [&] { return resolved.validateProjectMetadata(); });
+            !details.empty())
+        {
             logger->error("Invalid project metadata found.");
             co_await issues->addIssue(ProjectIssueLevel::ERROR, ProjectIssueType::META, ProjectError::INVALID_META, details);
             co_return ProjectError::INVALID_META;
         }
 
         // Validate pages
+        timer.begin("validate_pages");
         co_await resolved.validatePages();
         if (issues->hasErrors()) {
             logger->error("Found invalid page, aborting");
             co_return ProjectError::UNKNOWN;
         }
+        // Stop before the costly ingestion and copy stages
+        if (isDeploymentCancelled(project)) {
+            logger->info("Deployment superseded by a newer push, cancelling");
+            co_return ProjectError::CANCELLED;
+        }
+
+        // Compare with the active deployment
+        timer.begin("diff");
+        std::optional<DeploymentChanges> changes;
+        if (previous) {
+            const auto previousIssues = std::make_shared<ProjectIssueCallback>("", logger);
+            const ResolvedProject previousResolved{project, getDeploymentVersionedDir(*previous), *defaultVersion, previousIssues,
+                                                   projectLog};
+            changes = co_await runOnWorker<std::optional<DeploymentChanges>>(workerLoop, [&] {
+                return getDeploymentChanges(repo.get(), resolved, previousResolved, *previous, *revision, logger);
+            });
+        }
 
         // TODO Ingest from other versions?
-        // TODO Move transaction scope up
-        content::Ingestor ingestor{resolved, logger, issues, {}, true};
-        if (const auto result = co_await ingestor.runIngestor(); result != Error::Ok) {
-            logger->error("Error ingesting project data");
-            co_return ProjectError::UNKNOWN;
+        timer.begin("ingest");
+        std::optional<ProjectVersion> stagingVersion;
+        if (changes && !changes->reingest) {
+            logger->info("Game content unchanged since the active deployment, skipping ingestion");
+            // Ingestion issues still apply to the unchanged content
+            if (const auto result = co_await global::database->copyDeploymentIssues(previous->getValueOfId(), deployment.getValueOfId(),
+                                                                                    ProjectIssueType::INGESTOR);
+                !result) {
+                logger->error("Failed to copy ingestion issues from deployment {}", previous->getValueOfId());
+            }
+        } else {
+            // Content is written to a staging version that readers cannot see until the deployment is activated,
+            // the previous content is removed later in the background
+            const auto staging = co_await global::database->createStagingVersion(project.getValueOfId(), project.getValueOfSourceBranch(),
+                                                                                deployment.getValueOfId());
+            if (!staging) {
+                logger->error("Staging version creation database error.");
+                co_await issues->addIssue(ProjectIssueLevel::ERROR, ProjectIssueType::INTERNAL, ProjectError::UNKNOWN);
+                co_return ProjectError::UNKNOWN;
+            }
+            stagingVersion = *staging;
+
+            ResolvedProject staged{project, cloneDocsRoot, *staging, issues, projectLog};
+            content::Ingestor ingestor{staged, logger, issues, {}, false};
+            if (const auto result = co_await ingestor.runIngestor(); result != Error::Ok) {
+                logger->error("Error ingesting project data");
+                co_return ProjectError::UNKNOWN;
+            }
+            metrics.rows_inserted = co_await staged.getProjectDatabase().getIngestedRowCount();
         }
 
         if (issues->hasErrors()) {
@@ -218,33 +488,79 @@ namespace service {
         }
 
         // 6. Setup versions
-        const auto branches = git::listBranches(repo);
+        timer.begin("setup_versions");
+        const auto branches = co_await runOnWorker<std::unordered_map<std::string, std::string>>(
+            workerLoop, [&] { return git::listBranches(repo.get()); });
         const auto versions = co_await setupProjectVersions(resolved, branches, logger, issues);
 
         // 7. Copy default version
+        timer.begin("copy");
+        CopyCounters counters;
         const auto dest = getDeploymentVersionedDir(deployment);
-        copyProjectFiles(cloneDocsRoot, dest, logger);
+        const auto copied = co_await runOnWorker<Error>(workerLoop, [&] {
+            repo.reset();
+
+            if (const auto result = copyProjectFiles(cloneDocsRoot, dest, blobs_, counters, logger, changes ? &*changes : nullptr);
+                result != Error::Ok)
+            {
+                return result;
+            }
+            writeTreeIndex(project, *defaultVersion, dest, logger);
+            if (bundleFormat_) {
+                writeBundle(dest, logger);
+            }
+            getDeploymentMetadata(deployment);
+            getDeploymentBundle(deployment);
+            return Error::Ok;
+        });
+        if (copied != Error::Ok) {
+            logger->error("Error copying project files");
+            co_await issues->addIssue(ProjectIssueLevel::ERROR, ProjectIssueType::INTERNAL, ProjectError::UNKNOWN);
+            co_return ProjectError::UNKNOWN;
+        }
 
         // 8. Copy other versions
         // FIXME Error if wiki metadata does not exist in version / has errors
+        timer.begin("copy_versions");
+        std::vector<VersionCheckout> checkouts;
         for (const auto &version: versions) {
             const auto name = version.getValueOfName();
-            const auto branch = version.getValueOfBranch();
-            logger->info("Setting up version '{}' on branch '{}'", name, branch);
-
-            const auto branchRef = branches.at(branch);
-            if (const auto err = git::checkoutBranch(repo, branchRef, logger); err != Error::Ok) {
-                continue;
+            checkouts.push_back({.version = version,
+                                 .treeish = branches.at(version.getValueOfBranch()),
+                                 .checkoutDir = clonePath.string() + "-" + name,
+                                 .dest = getDeploymentVersionedDir(deployment, name)});
+        }
+        const auto versionResults = co_await runOnWorker<std::vector<Error>>(workerLoop, [&] {
+            return materializeVersions(project, clonePath, checkouts, blobs_, counters, bundleFormat_, logger);
+        });
+        metrics.files_copied = counters.copied;
+        metrics.files_reused = counters.reused;
+
+        // A missing version would only surface as not found errors for readers of the deployment
+        bool versionsFailed = false;
+        for (size_t i = 0; i < checkouts.size(); i++) {
+            if (versionResults[i] != Error::Ok) {
+                co_await issues->addIssue(ProjectIssueLevel::ERROR, ProjectIssueType::INTERNAL, ProjectError::UNKNOWN,
+                                          checkouts[i].version.getValueOfName());
+                versionsFailed = true;
             }
-
-            const auto versionDest = getDeploymentVersionedDir(deployment, name);
-            copyProjectFiles(cloneDocsRoot, versionDest, logger);
+        }
+        if (versionsFailed) {
+            logger->error("Failed to set up project versions, aborting");
+            co_return ProjectError::UNKNOWN;
         }
 
-        git_repository_free(repo);
+        co_await runOnWorker<bool>(workerLoop, [&] {
+            for (const auto &version: versions) {
+                getDeploymentMetadata(deployment, version.getValueOfName());
+                getDeploymentBundle(deployment, version.getValueOfName());
+            }
+            return true;
+        });
 
         // 9. Set active
-        if (const auto result = co_await setActiveDeployment(project.getValueOfId(), deployment); !result) {
+        timer.begin("activate");
+        if (const auto result = co_await setActiveDeployment(project.getValueOfId(), deployment, stagingVersion); !result) {
             logger->error("Error setting active deployment");
             co_return ProjectError::UNKNOWN;
         }
@@ -262,13 +578,17 @@ namespace service {
     }
 
     Task<std::tuple<std::optional<Deployment>, ProjectError>> Storage::deployProjectCached(const Project &project,
-                                                                                           const std::string userId) {
+                                                                                           const std::string userId,
+                                                                                           trantor::EventLoop *workerLoop) {
         const auto taskKey = createProjectSetupKey(project);
 
         if (const auto pending = co_await getOrStartTask<std::tuple<std::optional<Deployment>, ProjectError>>(taskKey)) {
             co_return co_await patientlyAwaitTaskResult(*pending);
         }
 
+        // Cancellation requests only apply to the deployment that was running when they were made
+        clearDeploymentCancelled(project);
+
         const auto activeDeployment(co_await global::database->getActiveDeployment(project.getValueOfId()));
 
         const auto projectId = project.getValueOfId();
@@ -288,51 +608,72 @@ namespace service {
         auto deployment = *dbResult;
 
         const auto deploymentDir = getDeploymentRootDir(deployment);
-        remove_all(deploymentDir);
-        fs::create_directories(deploymentDir);
-
         const auto clonePath = getBaseDir().path() / TEMP_DIR / (projectId + "-" + deployment.getValueOfId().substr(0, 9));
-        remove_all(clonePath);
+        co_await runOnWorker<bool>(workerLoop, [&] {
+            remove_all(deploymentDir);
+            remove_all(clonePath);
+            return fs::create_directories(deploymentDir);
+        });
 
         const auto deployLog = getDeploymentLogger(deployment);
         ProjectError result;
+        DeploymentMetrics metrics;
+        const auto started = std::chrono::steady_clock::now();
+        const auto startPeakMemoryKb = getPeakMemoryKb();
         try {
-            result = co_await deployProject(project, deployment, clonePath);
+            const auto previous = activeDeployment ? std::optional{*activeDeployment} : std::nullopt;
+            result = co_await deployProject(project, deployment, clonePath, previous, workerLoop, metrics);
         } catch (std::exception &e) {
             result = ProjectError::UNKNOWN;
             logger.error("Unexpected error during deployment: {}", e.what());
         }
+        metrics.total_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+        metrics.process_peak_memory_kb = getPeakMemoryKb();
+        metrics.peak_memory_growth_kb = metrics.process_peak_memory_kb - startPeakMemoryKb;
+
+        for (const auto &[name, duration]: metrics.stages) {
+            deployLog->debug("Stage '{}' took {} ms", name, duration);
+        }
 
         if (result == ProjectError::OK) {
             deployLog->info("====================================");
             deployLog->info("==   Project deployment complete  ==");
             deployLog->info("====================================");
 
-            deployment.setStatus(enumToStr(DeploymentStatus::SUCCESS));
-
-            // Cleanup previous data
+            // Cleanup previous data, no longer visible to readers since the activation was committed
             try {
                 if (activeDeployment) {
                     const auto oldPath = getDeploymentRootDir(*activeDeployment);
                     deployLog->info("Cleaning up previous deployment");
-                    remove_all(oldPath);
+                    trash_.retire(oldPath);
+                    evictDeploymentCaches(*activeDeployment);
                 }
             } catch (std::exception &e) {
                 const auto id = activeDeployment ? activeDeployment->getValueOfId() : "";
                 logger.error("Failed to cleanup previous deployment '{}': {}", id, e.what());
             }
         } else {
-            deployLog->error("!!================================!!");
-            deployLog->error("!!   Project deployment failed    !!");
-            deployLog->error("!!================================!!");
+            if (result == ProjectError::CANCELLED) {
+                deployLog->info("Project deployment cancelled");
 
-            deployment.setStatus(enumToStr(DeploymentStatus::ERROR));
+                deployment.setStatus(enumToStr(DeploymentStatus::CANCELLED));
+            } else {
+                deployLog->error("!!================================!!");
+                deployLog->error("!!   Project deployment failed    !!");
+                deployLog->error("!!================================!!");
 
-            remove_all(deploymentDir);
+                deployment.setStatus(enumToStr(DeploymentStatus::ERROR));
+            }
+
+            trash_.retire(deploymentDir);
+            evictDeploymentCaches(deployment);
         }
+        clearDeploymentCancelled(project);
 
-        remove_all(clonePath);
+        trash_.retire(clonePath);
         co_await global::database->updateModel(deployment);
+        co_await global::database->setDeploymentMetrics(deployment.getValueOfId(), nlohmann::json(metrics).dump());
 
         global::connections->complete(projectId, result == ProjectError::OK);
 
@@ -341,39 +682,45 @@ namespace service {
 
     Task<std::tuple<std::optional<nlohmann::json>, ProjectError, std::string>>
     Storage::setupValidateTempProject(const Project &project) const {
-        const auto baseDir = getBaseDir();
-        const auto clonePath = baseDir.path() / TEMP_DIR / project.getValueOfId();
-        remove_all(clonePath);
-
         const auto logger = getProjectLogger(project, false);
 
-        // Clone project - validates repo and branch
-        if (const auto [repo, cloneError] =
-                co_await git::cloneRepository(project.getValueOfSourceRepo(), clonePath, project.getValueOfSourceBranch(), logger);
-            !repo || cloneError.error != ProjectError::OK)
-        {
-            remove_all(clonePath);
-            co_return {std::nullopt, cloneError.error, cloneError.message};
-        }
-
-        // Validate path
-        const auto docsPath = clonePath / removeLeadingSlash(project.getValueOfSourcePath());
-        if (!exists(docsPath)) {
-            remove_all(clonePath);
-            co_return {std::nullopt, ProjectError::NO_PATH, ""};
-        }
+        // Cloning and reading the project blocks for long, so it runs on the deployment threads rather than delaying the
+        // file reads of requests
+        co_return co_await supplyDeploymentWork<std::tuple<std::optional<nlohmann::json>, ProjectError, std::string>>(
+            [&]() -> std::tuple<std::optional<nlohmann::json>, ProjectError, std::string> {
+                const auto baseDir = getBaseDir();
+                const auto clonePath = baseDir.path() / TEMP_DIR / project.getValueOfId();
+                remove_all(clonePath);
+
+                // Clone project - validates repo and branch
+                const auto [repo, cloneError] = mirrors_.cloneRepository(project.getValueOfSourceRepo(), clonePath,
+                                                                         project.getValueOfSourceBranch(),
+                                                                         project.getValueOfSourcePath(), logger);
+                if (repo) {
+                    git_repository_free(repo);
+                }
+                if (!repo || cloneError.error != ProjectError::OK) {
+                    remove_all(clonePath);
+                    return {std::nullopt, cloneError.error, cloneError.message};
+                }
 
-        const auto issues = std::make_shared<ProjectIssueCallback>("", logger);
-        const ResolvedProject resolved{project, docsPath, ProjectVersion{}, issues, logger};
+                // Validate path
+                const auto docsPath = clonePath / removeLeadingSlash(project.getValueOfSourcePath());
+                if (!exists(docsPath)) {
+                    remove_all(clonePath);
+                    return {std::nullopt, ProjectError::NO_PATH, ""};
+                }
 
-        // Validate metadata
-        const auto [json, error, details] = resolved.validateProjectMetadata();
-        if (error != ProjectError::OK) {
-            remove_all(clonePath);
-            co_return {std::nullopt, error, details};
-        }
+                const auto issues = std::make_shared<ProjectIssueCallback>("", logger);
+                const ResolvedProject resolved{project, docsPath, ProjectVersion{}, issues, logger};
 
-        remove_all(clonePath);
-        co_return {*json, ProjectError::OK, ""};
+                // Validate metadata
+                const auto [json, error, details] = resolved.validateProjectMetadata();
+                remove_all(clonePath);
+                if (error != ProjectError::OK) {
+                    return {std::nullopt, error, details};
+                }
+                return {*json, ProjectError::OK, ""};
+            });
     }
 }
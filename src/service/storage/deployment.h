@@ -1,6 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <service/error.h>
+#include <service/storage/blobs.h>
+#include <spdlog/spdlog.h>
 #include <string>
+#include <vector>
 
 namespace service {
     enum class DeploymentStatus {
@@ -8,7 +17,92 @@ namespace service {
         CREATED,
         LOADING,
         SUCCESS,
-        ERROR
+        ERROR,
+        CANCELLED
     };
     DECLARE_ENUM(DeploymentStatus);
+
+    // Higher priority jobs are deployed first
+    enum class DeploymentPriority {
+        AUTOMATIC = 0,
+        MANUAL = 10
+    };
+
+    struct DeploymentStage {
+        std::string name;
+        int64_t duration_ms;
+
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(DeploymentStage, name, duration_ms)
+    };
+
+    // Recorded for each deployment to find out which stage dominates a slow deploy
+    struct DeploymentMetrics {
+        std::vector<DeploymentStage> stages;
+        int64_t total_ms = 0;
+        int64_t bytes_cloned = 0;
+        int64_t files_copied = 0;
+        int64_t files_reused = 0;
+        // Unset when the deployment did not ingest any content
+        std::optional<int64_t> rows_inserted;
+        // Process-wide high water mark at the end of the deployment, which shares the process with request handling
+        int64_t process_peak_memory_kb = 0;
+        // How far the deployment raised that mark, zero if the process peaked before
+        int64_t peak_memory_growth_kb = 0;
+
+        friend void to_json(nlohmann::json &j, const DeploymentMetrics &m) {
+            j = nlohmann::json{{"stages", m.stages},
+                               {"total_ms", m.total_ms},
+                               {"bytes_cloned", m.bytes_cloned},
+                               {"files_copied", m.files_copied},
+                               {"files_reused", m.files_reused},
+                               {"rows_inserted", m.rows_inserted ? nlohmann::json(*m.rows_inserted) : nlohmann::json(nullptr)},
+                               {"process_peak_memory_kb", m.process_peak_memory_kb},
+                               {"peak_memory_growth_kb", m.peak_memory_growth_kb}};
+        }
+    };
+
+    // Records how long each stage takes. The running stage is closed when the next one begins or the timer goes
+    // out of scope, so early returns are accounted for as well. Without metrics to record into, timing is a no-op.
+    class StageTimer {
+    public:
+        explicit StageTimer(DeploymentMetrics *metrics) : metrics_(metrics) {}
+        ~StageTimer() { finish(); }
+
+        void begin(const std::string &name) {
+            finish();
+            stage_ = name;
+            start_ = std::chrono::steady_clock::now();
+        }
+
+        void finish() {
+            if (stage_.empty() || !metrics_) {
+                return;
+            }
+            const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_);
+            metrics_->stages.push_back({.name = stage_, .duration_ms = elapsed.count()});
+            stage_.clear();
+        }
+
+    private:
+        DeploymentMetrics *metrics_;
+        std::string stage_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    int64_t getPeakMemoryKb();
+
+    // Difference between the active deployment and the revision being deployed
+    struct DeploymentChanges;
+
+    // Shared by the copy workers of every version in a deployment
+    struct CopyCounters {
+        std::atomic<int64_t> copied{0};
+        std::atomic<int64_t> reused{0};
+    };
+
+    // Copies the files of a docs tree into a version directory on the deployment threads. Files unchanged since the previous
+    // deployment are linked to its copy, others to the shared blob of identical content.
+    Error copyProjectFiles(const std::filesystem::path &docsRoot, const std::filesystem::path &dest, const BlobStore &blobs,
+                           CopyCounters &counters, const std::shared_ptr<spdlog::logger> &projectLog,
+                           const DeploymentChanges *changes = nullptr);
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "deployment_queue.h"
+
+#include <drogon/drogon.h>
+#include <log/log.h>
+#include <service/external/frontend.h>
+#include <service/project/cached/cached.h>
+#include <service/storage/storage.h>
+
+using namespace drogon;
+using namespace logging;
+
+namespace service {
+    DeploymentQueue::DeploymentQueue(const size_t concurrency) :
+        concurrency_(concurrency), running_(0), started_(0), totalWaitMs_(0), workers_(concurrency, "DeploymentWorker") {}
+
+    void DeploymentQueue::start() { workers_.start(); }
+
+    void DeploymentQueue::stop() {
+        for (const auto &loop: workers_.getLoops()) {
+            loop->quit();
+        }
+        workers_.wait();
+    }
+
+    Task<TaskResult<>> DeploymentQueue::enqueue(const Project &project, const std::string userId, const DeploymentPriority priority,
+                                                const std::chrono::milliseconds delay) {
+        const auto result = co_await global::database->enqueueDeploymentJob(project.getValueOfId(), userId, static_cast<int>(priority),
+                                                                             delay.count());
+        if (!result) {
+            logger.error("Failed to enqueue deployment for project '{}'", project.getValueOfId());
+            co_return result;
+        }
+
+        if (delay.count() > 0) {
+            dispatchAfter(delay);
+        } else {
+            co_await dispatch();
+        }
+        co_return Error::Ok;
+    }
+
+    Task<TaskResult<>> DeploymentQueue::enqueuePush(const Project &project) {
+        if (const auto result = co_await enqueue(project, "", DeploymentPriority::AUTOMATIC, PUSH_DEPLOYMENT_DELAY); !result) {
+            co_return result;
+        }
+
+        // A deployment of an older revision that is still in progress will be superseded anyway
+        global::storage->cancelDeployment(project);
+        co_return Error::Ok;
+    }
+
+    Task<> DeploymentQueue::restore() {
+        // Jobs interrupted by a shutdown are started again
+        if (const auto result = co_await global::database->requeueRunningDeploymentJobs(); !result) {
+            logger.error("Failed to restore deployment queue");
+            co_return;
+        }
+
+        co_await dispatch();
+        // Pick up delayed jobs once their delay has surely passed
+        dispatchAfter(PUSH_DEPLOYMENT_DELAY);
+    }
+
+    void DeploymentQueue::dispatchAfter(const std::chrono::milliseconds delay) {
+        // Leave some headroom for the database clock
+        const auto seconds = std::chrono::duration<double>(delay).count() + 0.1;
+        app().getLoop()->runAfter(seconds, async_func([this]() -> Task<> { co_await dispatch(); }));
+    }
+
+    Task<> DeploymentQueue::dispatch() {
+        while (true) {
+            if (running_.fetch_add(1) >= concurrency_) {
+                --running_;
+                co_return;
+            }
+
+            const auto job = co_await global::database->claimDeploymentJob();
+            if (!job) {
+                --running_;
+                co_return;
+            }
+
+            // Jobs run on the main loop, which owns a database client, and only hand blocking stages to a worker
+            app().getLoop()->queueInLoop(async_func([this, job = *job]() -> Task<> { co_await runJob(job); }));
+        }
+    }
+
+    Task<> DeploymentQueue::runJob(const DeploymentJob job) {
+        started_ += 1;
+        totalWaitMs_ += job.wait_ms;
+
+        if (const auto project = co_await global::database->getProjectSource(job.project_id)) {
+            logger.debug("Deploying project '{}' from branch '{}' after waiting {} ms in queue", project->getValueOfId(),
+                         project->getValueOfSourceBranch(), job.wait_ms);
+
+            try {
+                if (const auto result = co_await global::storage->deployProject(*project, job.user_id, workers_.getNextLoop()); result) {
+                    logger.debug("Project '{}' deployed successfully", project->getValueOfId());
+
+                    co_await clearProjectCache(project->getValueOfId());
+                    co_await global::frontend->revalidateProject(project->getValueOfId());
+                } else {
+                    logger.error("Encountered error while deploying project '{}'", project->getValueOfId());
+                }
+            } catch (std::exception &e) {
+                logger.error("Unexpected error while deploying project '{}': {}", project->getValueOfId(), e.what());
+            }
+        }
+
+        co_await global::database->completeDeploymentJob(job.id);
+
+        --running_;
+        co_await dispatch();
+    }
+
+    Task<DeploymentWorkerStats> DeploymentQueue::getStats() const {
+        const auto queue = co_await global::database->getDeploymentQueueStats();
+        const auto started = started_.load();
+
+        co_return DeploymentWorkerStats{.queue = queue,
+                                        .workers = concurrency_,
+                                        .started = started,
+                                        .average_wait_ms = started > 0 ? totalWaitMs_.load() / started : 0};
+    }
+}
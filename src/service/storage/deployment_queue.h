@@ -0,0 +1,62 @@
+#pragma once
+
+#include <drogon/utils/coroutine.h>
+#include <models/Project.h>
+#include <service/database/database.h>
+#include <service/storage/deployment.h>
+#include <trantor/net/EventLoopThreadPool.h>
+
+using namespace drogon_model::postgres;
+
+namespace service {
+    // Pushes arriving within this window are coalesced into a single deployment
+    constexpr std::chrono::seconds PUSH_DEPLOYMENT_DELAY{10};
+
+    struct DeploymentWorkerStats {
+        DeploymentQueueStats queue;
+        size_t workers;
+        int64_t started;
+        int64_t average_wait_ms;
+
+        friend void to_json(nlohmann::json &j, const DeploymentWorkerStats &s) {
+            j = nlohmann::json{{"queued", s.queue.queued},
+                               {"running", s.queue.running},
+                               {"oldest_wait_ms", s.queue.oldest_wait_ms},
+                               {"workers", s.workers},
+                               {"started", s.started},
+                               {"average_wait_ms", s.average_wait_ms}};
+        }
+    };
+
+    // Runs the blocking stages of deployments on dedicated worker threads, separate from HTTP serving.
+    // Jobs are persisted in the database so that pending deployments survive restarts.
+    class DeploymentQueue {
+    public:
+        explicit DeploymentQueue(size_t concurrency);
+
+        void start();
+        void stop();
+
+        drogon::Task<TaskResult<>> enqueue(const Project &project, std::string userId, DeploymentPriority priority,
+                                           std::chrono::milliseconds delay = {});
+        drogon::Task<TaskResult<>> enqueuePush(const Project &project);
+        drogon::Task<> restore();
+
+        drogon::Task<DeploymentWorkerStats> getStats() const;
+
+    private:
+        drogon::Task<> dispatch();
+        void dispatchAfter(std::chrono::milliseconds delay);
+        drogon::Task<> runJob(DeploymentJob job);
+
+        const size_t concurrency_;
+        std::atomic<size_t> running_;
+        std::atomic<int64_t> started_;
+        std::atomic<int64_t> totalWaitMs_;
+        trantor::EventLoopThreadPool workers_;
+    };
+}
+
+namespace global {
+    extern std::shared_ptr<service::DeploymentQueue> deployments;
+}
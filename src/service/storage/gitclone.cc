@@ -2,16 +2,16 @@
 
 #include <git2.h>
 #include <include/uri.h>
-#include <process.hpp>
 
 // 500 MB
 #define MAX_REPO_SIZE_BYTES 500 * 1024 * 1024
 #define CODE_SIZE_EXCEEDED -99
+// Remote branches are mirrored as local branches of the bare repository
+#define MIRROR_FETCHSPEC "+refs/heads/*:refs/heads/*"
 
 using namespace logging;
 using namespace service;
 using namespace drogon;
-using namespace TinyProcessLib;
 namespace fs = std::filesystem;
 
 namespace git {
@@ -25,178 +25,203 @@ namespace git {
         }
     }
 
-    uintmax_t getDirSize(const fs::path &dir) {
-        if (!fs::exists(dir)) {
-            return 0;
+    int transfer_progress(const git_indexer_progress *stats, void *payload) {
+        const auto data = static_cast<GitProgressData *>(payload);
+        data->receivedBytes = stats->received_bytes;
+
+        // Abort as soon as the received pack grows past the limit
+        if (stats->received_bytes > data->maxBytes) {
+            data->sizeExceeded = true;
+            return CODE_SIZE_EXCEEDED;
         }
 
-        uintmax_t size = 0;
-        try {
-            for (const auto &entry: fs::recursive_directory_iterator(dir, fs::directory_options::skip_permission_denied)) {
-                if (fs::is_regular_file(entry)) {
-                    size += entry.file_size();
-                }
-            }
-        } catch (...) {
-            // Ignore error
+        if (stats->received_objects == stats->total_objects || data->tick++ % 1000 == 0) {
+            data->logger->trace("git: Receiving objects: {}/{} ({} KiB)", stats->received_objects, stats->total_objects,
+                                stats->received_bytes / 1024);
         }
 
-        return size;
+        return 0;
     }
 
-    void processLogLines(const std::string &chunk, const std::string &logProgram, const std::shared_ptr<spdlog::logger> &logger) {
-        size_t pos;
-        std::string logBuffer = chunk;
-        // Find the next newline
-        while ((pos = logBuffer.find_first_of("\r\n")) != std::string::npos) {
-            // Extract line
-            std::string line = logBuffer.substr(0, pos);
-
-            // Check if it's a CRLF (\r\n) so we don't leave a dangling \n
-            size_t eraseLength = 1;
-            if (logBuffer[pos] == '\r' && pos + 1 < logBuffer.size() && logBuffer[pos + 1] == '\n') {
-                eraseLength = 2;
-            }
-
-            // Log the clean line
-            if (!line.empty()) {
-                logger->trace("{}: {}", logProgram, line);
-            }
+    int sideband_progress(const char *str, const int len, void *payload) {
+        const auto data = static_cast<GitProgressData *>(payload);
 
-            // Remove line from buffer
-            logBuffer.erase(0, pos + eraseLength);
+        std::string line{str, static_cast<size_t>(len)};
+        std::erase_if(line, [](const char c) { return c == '\r' || c == '\n'; });
+        if (!line.empty()) {
+            data->logger->trace("remote: {}", line);
         }
+
+        return 0;
     }
 
-    // TODO Dedicated thread pool for cloning
-    std::pair<int, std::string> executeCloneCmd(const std::string &command, const fs::path &destPath, const std::string &logProgram,
-                                                const std::shared_ptr<spdlog::logger> &logger) {
-        std::string result;
-        std::mutex mutex;
-        std::atomic finished{false};
-        std::atomic sizeLimitExceeded{false};
-
-        auto capture = [&](const char *bytes, const size_t n) {
-            std::lock_guard lock(mutex);
-
-            const std::string chunk(bytes, n);
-            result += chunk;
-
-            processLogLines(chunk, logProgram, logger);
-        };
-
-        Process::environment_type env{
-            {"LC_ALL", "C"}, // Output messages in english
-            {"GIT_TERMINAL_PROMPT", "0"} // Dont ask for credentials
-        };
-        Process process(command, "", env, capture, capture);
-
-        std::thread watchdog([&]() {
-            while (!finished) {
-                const auto currentSize = getDirSize(destPath);
-
-                if (currentSize > MAX_REPO_SIZE_BYTES) {
-                    sizeLimitExceeded = true;
-                    process.kill();
-                    break;
-                }
-
-                // Sleep for 500ms before checking again
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            }
-        });
+    ProjectErrorInstance getCloneError(const int code, const GitProgressData &progress) {
+        if (progress.sizeExceeded || code == CODE_SIZE_EXCEEDED) {
+            return {ProjectError::REPO_TOO_LARGE, "Repository exceeded size limit (500MB)."};
+        }
 
-        int status = process.get_exit_status();
+        const auto error = git_error_last();
+        const std::string message = error && error->message ? error->message : "";
+        const auto errorClass = error ? error->klass : GIT_ERROR_NONE;
 
-        finished = true;
-        if (watchdog.joinable()) {
-            watchdog.join();
+        // Authentication
+        if (code == GIT_EAUTH || contains(message, "authentication") || contains(message, "401") || contains(message, "403")) {
+            return {ProjectError::REQUIRES_AUTH, "Authentication required."};
         }
 
-        if (sizeLimitExceeded) {
-            return {CODE_SIZE_EXCEEDED, result};
+        // Invalid URL / private repo
+        if (contains(message, "404") || (errorClass == GIT_ERROR_NET || errorClass == GIT_ERROR_REPOSITORY) && code == GIT_ENOTFOUND) {
+            return {ProjectError::NO_REPOSITORY};
         }
 
-        return {status, result};
+        // Branch
+        if (errorClass == GIT_ERROR_REFERENCE || code == GIT_ENOTFOUND) {
+            return {ProjectError::NO_BRANCH, "Requested branch not found."};
+        }
+
+        // Size / Network
+        if (errorClass == GIT_ERROR_NET || errorClass == GIT_ERROR_NOMEMORY) {
+            return {ProjectError::REPO_TOO_LARGE, "Repository clone failed (network)."};
+        }
+
+        return {ProjectError::UNKNOWN};
     }
 
-    ProjectErrorInstance runGitClone(const std::string &url, const fs::path &path, const std::string &branch, const bool shallow,
-                                     const std::shared_ptr<spdlog::logger> &logger) {
-        std::string cmd = "git clone --progress ";
+    std::tuple<git_repository *, ProjectErrorInstance> runGitClone(const std::string &url, const fs::path &path, const std::string &branch,
+                                                                   const std::string &sparsePath, const bool shallow, const bool local,
+                                                                   const std::shared_ptr<spdlog::logger> &logger, size_t *receivedBytes) {
+        GitProgressData progress{
+            .tick = 0, .logger = logger, .maxBytes = MAX_REPO_SIZE_BYTES, .sizeExceeded = false, .receivedBytes = 0};
+
+        git_clone_options opts = GIT_CLONE_OPTIONS_INIT;
+        opts.fetch_opts.callbacks.transfer_progress = transfer_progress;
+        opts.fetch_opts.callbacks.sideband_progress = sideband_progress;
+        opts.fetch_opts.callbacks.payload = &progress;
+        // All remote branches are fetched, which is required for setting up versions
         if (shallow) {
-            cmd += "--depth 1 --no-single-branch ";
+            opts.fetch_opts.depth = 1;
+        }
+        // Hardlink objects instead of transferring them when cloning from a mirror
+        if (local) {
+            opts.local = GIT_CLONE_LOCAL;
         }
         if (!branch.empty()) {
-            cmd += "--branch " + branch + " ";
+            opts.checkout_branch = branch.c_str();
+        }
+        // Only the docs are written to disk, everything else in the repository stays in the object store
+        std::string pathspec = removeLeadingSlash(sparsePath);
+        if (!pathspec.empty() && !pathspec.ends_with('/')) {
+            pathspec += '/';
+        }
+        char *paths[] = {pathspec.data()};
+        if (!pathspec.empty()) {
+            opts.checkout_opts.paths = {paths, 1};
         }
-        cmd += "\"" + url + "\" ";
-        cmd += "\"" + path.string() + "\"";
 
-        try {
-            auto [exitCode, output] = executeCloneCmd(cmd, path, "git", logger);
-            if (exitCode == 0) {
-                return {ProjectError::OK};
+        git_repository *repo = nullptr;
+        const auto code = git_clone(&repo, url.c_str(), path.c_str(), &opts);
+        if (receivedBytes) {
+            *receivedBytes = progress.receivedBytes;
+        }
+        if (code != 0) {
+            const auto error = getCloneError(code, progress);
+            if (const auto last = git_error_last(); last && last->message) {
+                logger->error("Error cloning repository: {}", last->message);
             }
+            git_repository_free(repo);
+            return {nullptr, error};
+        }
 
-            if (exitCode == CODE_SIZE_EXCEEDED) {
-                return {ProjectError::REPO_TOO_LARGE, "Repository exceeded size limit (500MB)."};
-            }
+        return {repo, {ProjectError::OK}};
+    }
 
-            // Invalid URL / private repo
-            if (contains(output, "Repository not found")) {
-                return {ProjectError::NO_REPOSITORY};
-            }
+    ProjectErrorInstance fetchMirror(const std::string &url, const fs::path &mirrorPath, const std::shared_ptr<spdlog::logger> &logger,
+                                     size_t *receivedBytes) {
+        GitProgressData progress{
+            .tick = 0, .logger = logger, .maxBytes = MAX_REPO_SIZE_BYTES, .sizeExceeded = false, .receivedBytes = 0};
 
-            // Authentication
-            if (contains(output, "Authentication failed") || contains(output, "could not read Username") || contains(output, "HTTP 401") ||
-                contains(output, "HTTP 403") || contains(output, "terminal prompts disabled"))
-            {
-                return {ProjectError::REQUIRES_AUTH, "Authentication required."};
+        git_repository *repo = nullptr;
+        git_remote *remote = nullptr;
+        int code;
+        if (git_repository_open_bare(&repo, absolute(mirrorPath).c_str()) == 0) {
+            code = git_remote_lookup(&remote, repo, "origin");
+        } else {
+            logger->info("Creating mirror of git repository at {}", url);
+            code = git_repository_init(&repo, absolute(mirrorPath).c_str(), true);
+            if (code == 0) {
+                code = git_remote_create_with_fetchspec(&remote, repo, "origin", url.c_str(), MIRROR_FETCHSPEC);
             }
+        }
 
-            // Branch
-            if (contains(output, "Remote branch") || contains(output, "pathspec") || contains(output, "not found in upstream")) {
-                return {ProjectError::NO_BRANCH, "Requested branch not found."};
+        if (code == 0) {
+            // Only objects missing from the mirror are transferred. Like direct clones, mirrors only receive the branch tips
+            // instead of the repository's full history.
+            git_fetch_options opts = GIT_FETCH_OPTIONS_INIT;
+            opts.depth = 1;
+            opts.callbacks.transfer_progress = transfer_progress;
+            opts.callbacks.sideband_progress = sideband_progress;
+            opts.callbacks.payload = &progress;
+            opts.prune = GIT_FETCH_PRUNE;
+            opts.download_tags = GIT_REMOTE_DOWNLOAD_TAGS_NONE;
+            code = git_remote_fetch(remote, nullptr, &opts, "fetch");
+        }
+        if (code == 0) {
+            // Clones without an explicit branch check out the remote's default branch
+            if (git_buf head = GIT_BUF_INIT; git_remote_default_branch(&head, remote) == 0) {
+                git_repository_set_head(repo, head.ptr);
+                git_buf_dispose(&head);
             }
+        }
+
+        if (receivedBytes) {
+            *receivedBytes = progress.receivedBytes;
+        }
+        git_remote_free(remote);
+        git_repository_free(repo);
 
-            // Size / Network
-            if (contains(output, "RPC failed") || contains(output, "pack exceeds maximum") || contains(output, "early EOF") ||
-                contains(output, "out of memory"))
-            {
-                return {ProjectError::REPO_TOO_LARGE, "Repository clone failed (network)."};
+        if (code != 0) {
+            const auto error = getCloneError(code, progress);
+            if (const auto last = git_error_last(); last && last->message) {
+                logger->error("Error fetching repository: {}", last->message);
             }
+            return error;
+        }
+
+        logger->info("Fetched {} KiB into repository mirror", progress.receivedBytes / 1024);
+        return {ProjectError::OK};
+    }
+
+    std::tuple<git_repository *, ProjectErrorInstance> cloneFromMirror(const fs::path &mirrorPath, const fs::path &projectPath,
+                                                                       const std::string &branch, const std::string &sparsePath,
+                                                                       const std::shared_ptr<spdlog::logger> &logger) {
+        const auto path = absolute(projectPath);
+        const auto [repo, result] = runGitClone(absolute(mirrorPath).string(), path, branch, sparsePath, false, true, logger, nullptr);
 
-            // Unknown
-            std::ranges::replace(output, '\n', ' ');
-            return {ProjectError::UNKNOWN};
-        } catch (const std::exception &err) {
-            logger->error("Error cloning repository: {}", err.what());
-            return {ProjectError::UNKNOWN};
+        if (result.error != ProjectError::OK) {
+            logger->info("Git clone from mirror failed with error {}", result.message);
+            return {nullptr, result};
         }
+
+        logger->info("Git clone from mirror successful");
+        return {repo, {ProjectError::OK}};
     }
 
-    Task<std::tuple<git_repository *, ProjectErrorInstance>> cloneRepository(const std::string url, const fs::path projectPath,
-                                                                             const std::string branch,
-                                                                             const std::shared_ptr<spdlog::logger> logger) {
+    std::tuple<git_repository *, ProjectErrorInstance> cloneRepository(const std::string &url, const fs::path &projectPath,
+                                                                       const std::string &branch, const std::string &sparsePath,
+                                                                       const std::shared_ptr<spdlog::logger> &logger, size_t *receivedBytes) {
         logger->info("Cloning git repository at {}", url);
 
         const auto path = absolute(projectPath);
         const auto shallow = !is_local_url(url);
-        const auto result = runGitClone(url, path, branch, shallow, logger);
+        const auto [repo, result] = runGitClone(url, path, branch, sparsePath, shallow, false, logger, receivedBytes);
 
         if (result.error != ProjectError::OK) {
             logger->info("Git clone failed with error {}", result.message);
-            co_return {nullptr, result};
+            return {nullptr, result};
         }
 
         logger->info("Git clone successful");
 
-        git_repository *repo = nullptr;
-        if (git_repository_open(&repo, absolute(path).c_str()) != 0) {
-            logger->error("Failed to open repository: {}", path.string());
-            co_return {nullptr, {ProjectError::UNKNOWN, "Failed to open repository"}};
-        }
-
-        co_return {repo, {ProjectError::OK}};
+        return {repo, {ProjectError::OK}};
     }
 }
@@ -82,6 +82,43 @@ namespace git {
         return Error::Ok;
     }
 
+    Error checkoutTree(git_repository *repo, const std::string &treeish, const fs::path &target, const std::string &path,
+                       const std::shared_ptr<spdlog::logger> &logger) {
+        git_object *tree = nullptr;
+        if (git_revparse_single(&tree, repo, treeish.c_str()) != 0) {
+            logger->error("Failed to parse tree '{}'", treeish);
+            return Error::ErrInternal;
+        }
+
+        // Write into a separate directory without touching the repository's own index or worktree
+        const auto targetPath = absolute(target).string();
+        GitProgressData d = {.tick = 0, .logger = logger};
+        git_checkout_options opts = GIT_CHECKOUT_OPTIONS_INIT;
+        opts.checkout_strategy = GIT_CHECKOUT_FORCE | GIT_CHECKOUT_DONT_UPDATE_INDEX;
+        opts.target_directory = targetPath.c_str();
+        opts.progress_cb = checkout_progress;
+        opts.progress_payload = &d;
+
+        std::string pathspec = removeLeadingSlash(path);
+        if (!pathspec.empty() && !pathspec.ends_with('/')) {
+            pathspec += '/';
+        }
+        char *paths[] = {pathspec.data()};
+        if (!pathspec.empty()) {
+            opts.paths = {paths, 1};
+        }
+
+        const auto result = git_checkout_tree(repo, tree, &opts);
+        git_object_free(tree);
+
+        if (result != 0) {
+            logger->error("Failed to checkout tree '{}' to {}", treeish, targetPath);
+            return Error::ErrInternal;
+        }
+
+        return Error::Ok;
+    }
+
     std::unordered_map<std::string, std::string> listBranches(git_repository *repo) {
         std::unordered_map<std::string, std::string> branches;
 
@@ -157,4 +194,108 @@ namespace git {
                            .authorEmail = author_email,
                            .date = commitDate};
     }
+
+    Error fetchRevision(git_repository *repo, const std::string &hash, const std::shared_ptr<spdlog::logger> &logger) {
+        git_oid oid;
+        if (git_oid_fromstr(&oid, hash.c_str()) != 0) {
+            return Error::ErrBadRequest;
+        }
+
+        // Already present, e.g. in full clones of local repositories
+        if (git_commit *commit = nullptr; git_commit_lookup(&commit, repo, &oid) == 0) {
+            git_commit_free(commit);
+            return Error::Ok;
+        }
+
+        git_remote *remote = nullptr;
+        if (git_remote_lookup(&remote, repo, "origin") != 0) {
+            return Error::ErrInternal;
+        }
+
+        logger->debug("Fetching revision {}", hash);
+
+        git_fetch_options opts = GIT_FETCH_OPTIONS_INIT;
+        opts.depth = 1;
+        opts.download_tags = GIT_REMOTE_DOWNLOAD_TAGS_NONE;
+
+        std::string refspec = hash;
+        char *refspecs[] = {refspec.data()};
+        const git_strarray refspecArray{refspecs, 1};
+
+        const auto result = git_remote_fetch(remote, &refspecArray, &opts, nullptr);
+        git_remote_free(remote);
+
+        if (result != 0) {
+            const auto error = git_error_last();
+            logger->warn("Failed to fetch revision {}: {}", hash, error ? error->message : "unknown error");
+            return Error::ErrNotFound;
+        }
+
+        return Error::Ok;
+    }
+
+    std::optional<GitChangeSet> diffRevisions(git_repository *repo, const std::string &fromHash, const std::string &toHash,
+                                              const std::string &path) {
+        git_oid fromOid, toOid;
+        if (git_oid_fromstr(&fromOid, fromHash.c_str()) != 0 || git_oid_fromstr(&toOid, toHash.c_str()) != 0) {
+            return std::nullopt;
+        }
+
+        // Paths are reported relative to the given subdirectory
+        std::string prefix = removeLeadingSlash(path);
+        if (!prefix.empty() && !prefix.ends_with('/')) {
+            prefix += '/';
+        }
+
+        git_diff_options opts = GIT_DIFF_OPTIONS_INIT;
+        char *pathspec[] = {prefix.data()};
+        if (!prefix.empty()) {
+            opts.pathspec = {pathspec, 1};
+        }
+
+        git_commit *fromCommit = nullptr;
+        git_commit *toCommit = nullptr;
+        git_tree *fromTree = nullptr;
+        git_tree *toTree = nullptr;
+        git_diff *diff = nullptr;
+
+        std::optional<GitChangeSet> result;
+        if (git_commit_lookup(&fromCommit, repo, &fromOid) == 0 && git_commit_lookup(&toCommit, repo, &toOid) == 0 &&
+            git_commit_tree(&fromTree, fromCommit) == 0 && git_commit_tree(&toTree, toCommit) == 0 &&
+            git_diff_tree_to_tree(&diff, repo, fromTree, toTree, &opts) == 0 && git_diff_find_similar(diff, nullptr) == 0)
+        {
+            const auto relativePath = [&prefix](const char *file) -> std::optional<std::string> {
+                const std::string filePath{file};
+                if (!filePath.starts_with(prefix)) {
+                    return std::nullopt;
+                }
+                return filePath.substr(prefix.size());
+            };
+
+            GitChangeSet changes;
+            for (size_t i = 0; i < git_diff_num_deltas(diff); i++) {
+                const auto delta = git_diff_get_delta(diff, i);
+
+                if (delta->status == GIT_DELTA_DELETED || delta->status == GIT_DELTA_RENAMED) {
+                    if (const auto oldPath = relativePath(delta->old_file.path)) {
+                        changes.deleted.insert(*oldPath);
+                    }
+                }
+                if (delta->status != GIT_DELTA_DELETED) {
+                    if (const auto newPath = relativePath(delta->new_file.path)) {
+                        changes.changed.insert(*newPath);
+                    }
+                }
+            }
+            result = changes;
+        }
+
+        git_diff_free(diff);
+        git_tree_free(toTree);
+        git_tree_free(fromTree);
+        git_commit_free(toCommit);
+        git_commit_free(fromCommit);
+
+        return result;
+    }
 }
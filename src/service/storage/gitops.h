@@ -13,6 +13,9 @@ namespace git {
         size_t tick;
         std::string error;
         std::shared_ptr<spdlog::logger> logger;
+        size_t maxBytes;
+        bool sizeExceeded;
+        size_t receivedBytes;
     };
 
     struct GitRevision {
@@ -26,6 +29,11 @@ namespace git {
         NLOHMANN_DEFINE_TYPE_INTRUSIVE(GitRevision, hash, fullHash, message, authorName, authorEmail, date)
     };
 
+    struct GitChangeSet {
+        std::set<std::string> changed;
+        std::set<std::string> deleted;
+    };
+
     struct GitProvider {
         std::string filePath;
         std::string commitPath;
@@ -37,14 +45,33 @@ namespace git {
 
     service::Error checkoutBranch(git_repository *repo, const std::string &branch, const std::shared_ptr<spdlog::logger> &logger);
 
+    service::Error checkoutTree(git_repository *repo, const std::string &treeish, const std::filesystem::path &target,
+                                const std::string &path, const std::shared_ptr<spdlog::logger> &logger);
+
     std::unordered_map<std::string, std::string> listBranches(git_repository *repo);
 
     std::optional<GitRevision> getLatestRevision(const std::filesystem::path &path);
 
     std::optional<GitRevision> getLatestRevision(git_repository *repo);
 
-    drogon::Task<std::tuple<git_repository *, service::ProjectErrorInstance>> cloneRepository(std::string url,
-                                                                                              std::filesystem::path projectPath,
-                                                                                              std::string branch,
-                                                                                              std::shared_ptr<spdlog::logger> logger);
+    service::Error fetchRevision(git_repository *repo, const std::string &hash, const std::shared_ptr<spdlog::logger> &logger);
+
+    std::optional<GitChangeSet> diffRevisions(git_repository *repo, const std::string &fromHash, const std::string &toHash,
+                                              const std::string &path);
+
+    bool is_local_url(const std::string &str);
+
+    service::ProjectErrorInstance fetchMirror(const std::string &url, const std::filesystem::path &mirrorPath,
+                                              const std::shared_ptr<spdlog::logger> &logger, size_t *receivedBytes = nullptr);
+
+    std::tuple<git_repository *, service::ProjectErrorInstance> cloneFromMirror(const std::filesystem::path &mirrorPath,
+                                                                                const std::filesystem::path &projectPath,
+                                                                                const std::string &branch, const std::string &sparsePath,
+                                                                                const std::shared_ptr<spdlog::logger> &logger);
+
+    std::tuple<git_repository *, service::ProjectErrorInstance> cloneRepository(const std::string &url,
+                                                                                const std::filesystem::path &projectPath,
+                                                                                const std::string &branch, const std::string &sparsePath,
+                                                                                const std::shared_ptr<spdlog::logger> &logger,
+                                                                                size_t *receivedBytes = nullptr);
 }
@@ -68,8 +68,62 @@ namespace content {
         }
     }
 
+    bool isValidLocation(const std::string &loc) { return ResourceLocation::parse(loc).has_value(); }
+
+    Task<Error> Ingestor::runPreparation() const {
+        auto projectLog = *logger_;
+
+        if (!project_.getProject().getModid()) {
+            projectLog.debug("No content data to prepare.");
+            co_return Error::Ok;
+        }
+
+        StageTimer timer{metrics_};
+        ProjectFileIssueCallback rootFileIssues{issues_, project_.getFormat().getRoot()};
+        SubIngestors ingestors;
+        addSubModules(ingestors, rootFileIssues);
+
+        const auto allResults = co_await prepareIngestors(ingestors, timer);
+        if (!allResults) {
+            co_return Error::ErrInternal;
+        }
+
+        projectLog.info("Prepared {} items and {} tags", allResults->items.size(), allResults->tags.size());
+        co_return Error::Ok;
+    }
+
+    void Ingestor::setMetrics(DeploymentMetrics &metrics) { metrics_ = &metrics; }
+
     bool Ingestor::enableModule(const std::string &name) const { return enableModules_.empty() || enableModules_.contains(name); }
 
+    void Ingestor::addSubModules(SubIngestors &ingestors, ProjectFileIssueCallback &issues) const {
+        addSubModule<ContentPathsSubIngestor>(ingestors, INGESTOR_CONTENT_PATHS, issues);
+        addSubModule<TagsSubIngestor>(ingestors, INGESTOR_TAGS, issues);
+        addSubModule<RecipesSubIngestor>(ingestors, INGESTOR_RECIPES, issues);
+        addSubModule<MetadataSubIngestor>(ingestors, INGESTOR_METADATA, issues);
+    }
+
+    Task<std::optional<PreparationResult>> Ingestor::prepareIngestors(const SubIngestors &ingestors, StageTimer &timer) const {
+        auto projectLog = *logger_;
+
+        PreparationResult allResults;
+        for (const auto &[name, ingestor]: ingestors) {
+            projectLog.info("Preparing ingestor [{}]", name);
+            timer.begin(std::format("prepare [{}]", name));
+            try {
+                const auto [items, tags] = co_await ingestor->prepare();
+                std::ranges::copy_if(items, std::inserter(allResults.items, allResults.items.end()), isValidLocation);
+                std::ranges::copy_if(tags, std::inserter(allResults.tags, allResults.tags.end()), isValidLocation);
+            } catch (std::exception &e) {
+                issues_->addIssueAsync(ProjectIssueLevel::ERROR, ProjectIssueType::INGESTOR, ProjectError::UNKNOWN, e.what());
+                co_return std::nullopt;
+            }
+        }
+        timer.finish();
+
+        co_return allResults;
+    }
+
     Task<Error> Ingestor::ingestGameContentData() const {
         auto projectLog = *logger_;
 
@@ -82,44 +136,50 @@ namespace content {
             co_await wipeExistingData(project_.getProjectDatabase().getDbClientPtr(), projectId);
         }
 
+        StageTimer timer{metrics_};
         ProjectFileIssueCallback rootFileIssues{issues_, project_.getFormat().getRoot()};
-        std::vector<std::pair<std::string, std::unique_ptr<SubIngestor>>> ingestors;
-
-        addSubModule<ContentPathsSubIngestor>(ingestors, INGESTOR_CONTENT_PATHS, rootFileIssues);
-        addSubModule<TagsSubIngestor>(ingestors, INGESTOR_TAGS, rootFileIssues);
-        addSubModule<RecipesSubIngestor>(ingestors, INGESTOR_RECIPES, rootFileIssues);
-        addSubModule<MetadataSubIngestor>(ingestors, INGESTOR_METADATA, rootFileIssues);
+        SubIngestors ingestors;
+        addSubModules(ingestors, rootFileIssues);
 
         // Prepare ingestors
-        PreparationResult allResults;
-        for (const auto &[name, ingestor]: ingestors) {
-            projectLog.info("Preparing ingestor [{}]", name);
-            try {
-                const auto [items] = co_await ingestor->prepare();
-                allResults.items.insert(items.begin(), items.end());
-            } catch (std::exception &e) {
-                issues_->addIssueAsync(ProjectIssueLevel::ERROR, ProjectIssueType::INGESTOR, ProjectError::UNKNOWN, e.what());
-                co_return Error::ErrInternal;
+        const auto allResults = co_await prepareIngestors(ingestors, timer);
+        if (!allResults) {
+            co_return Error::ErrInternal;
+        }
+
+        // Resolve ids of all referenced locations once, so that ingestors insert by id instead of looking up locations per row
+        timer.begin("resolve_locations");
+        IngestedLocations locations;
+        {
+            projectLog.info("Resolving {} items and {} tags", allResults->items.size(), allResults->tags.size());
+
+            const auto &db = project_.getProjectDatabase();
+            const auto items = co_await db.upsertItems({allResults->items.begin(), allResults->items.end()});
+            if (!items) {
+                co_return items.error();
             }
+            const auto tags = co_await db.upsertTags({allResults->tags.begin(), allResults->tags.end()});
+            if (!tags) {
+                co_return tags.error();
+            }
+            locations = {.items = *items, .tags = *tags};
         }
 
-        std::set<std::string> candidateItems;
-        for (const auto &item: allResults.items) {
+        std::vector<int64_t> candidateItems;
+        for (const auto &[item, id]: locations.items) {
             if (const auto parsedId = ResourceLocation::parse(item); parsedId && parsedId->namespace_ == projectModid) {
-                candidateItems.insert(item);
+                candidateItems.push_back(id);
             }
         }
 
         // Register items
+        timer.begin("register_items");
         if (!candidateItems.empty()) {
             projectLog.info("Registering {} items", candidateItems.size());
 
-            for (const auto &item: candidateItems) {
-                projectLog.trace("Registering item '{}'", item);
-                if (const auto result = co_await project_.getProjectDatabase().addProjectItem(item); !result) {
-                    // TODO add issue
-                    co_return Error::ErrBadRequest;
-                }
+            if (const auto result = co_await project_.getProjectDatabase().addProjectItems(candidateItems); !result) {
+                // TODO add issue
+                co_return Error::ErrBadRequest;
             }
 
             projectLog.debug("Done registering items");
@@ -128,8 +188,9 @@ namespace content {
         // Execute ingestors
         for (const auto &[name, ingestor]: ingestors) {
             projectLog.info("Executing ingestor [{}]", name);
+            timer.begin(std::format("execute [{}]", name));
             try {
-                if (const auto error = co_await ingestor->execute(); error == Error::Ok) {
+                if (const auto error = co_await ingestor->execute(locations); error == Error::Ok) {
                     projectLog.debug("Ingestor executed successfully");
                 } else {
                     projectLog.error("Encountered error while executing ingestor");
@@ -144,6 +205,7 @@ namespace content {
         // Finish
         for (const auto &[name, ingestor]: ingestors) {
             projectLog.info("Finishing ingestor [{}]", name);
+            timer.begin(std::format("finish [{}]", name));
             try {
                 if (const auto error = co_await ingestor->finish(); error == Error::Ok) {
                     projectLog.debug("Ingestor finished successfully");
@@ -3,8 +3,11 @@
 #include "ingestor_metadata.h"
 
 #include <drogon/utils/coroutine.h>
+#include <service/database/project_database.h>
 #include <service/error.h>
+#include <service/parallel.h>
 #include <service/project/resolved.h>
+#include <service/storage/deployment.h>
 #include <service/storage/ingestor/recipe/recipe_parser.h>
 #include <service/storage/issues/issue_callback.h>
 
@@ -14,8 +17,34 @@
 #define INGESTOR_METADATA "Metadata"
 
 namespace content {
+    // Applies a function to every input on the deployment threads, which are joined on one of them so that the calling
+    // event loop is not blocked. Results keep the order of their inputs, issues reported by the function are recorded
+    // in whichever order the threads get to them.
+    template<typename T, typename F, typename R = std::invoke_result_t<F, const T &>>
+    drogon::Task<std::vector<R>> parallelMap(const std::vector<T> &inputs, F func) {
+        co_return co_await service::supplyDeploymentWork<std::vector<R>>([&] {
+            // Results are constructed in place, prepared data is not assignable
+            std::vector<std::optional<R>> slots(inputs.size());
+            service::parallelFor(inputs.size(), [&](const size_t i) { slots[i].emplace(func(inputs[i])); });
+
+            std::vector<R> results;
+            results.reserve(slots.size());
+            for (auto &slot: slots) {
+                results.push_back(std::move(*slot));
+            }
+            return results;
+        });
+    }
+
     struct PreparationResult {
         std::set<std::string> items;
+        std::set<std::string> tags;
+    };
+
+    // Database ids of every item and tag referenced by prepared data, resolved once before execution
+    struct IngestedLocations {
+        service::LocationIds items;
+        service::LocationIds tags;
     };
 
     template<typename T>
@@ -30,7 +59,7 @@ namespace content {
         virtual ~SubIngestor() = default;
 
         virtual drogon::Task<PreparationResult> prepare() = 0;
-        virtual drogon::Task<service::Error> execute() = 0;
+        virtual drogon::Task<service::Error> execute(const IngestedLocations &locations) = 0;
         virtual drogon::Task<service::Error> finish();
 
     protected:
@@ -39,20 +68,28 @@ namespace content {
         service::ProjectFileIssueCallback &issues_;
     };
 
+    using SubIngestors = std::vector<std::pair<std::string, std::unique_ptr<SubIngestor>>>;
+
     class Ingestor {
     public:
         explicit Ingestor(service::ProjectBase &, const std::shared_ptr<spdlog::logger> &, const std::shared_ptr<service::ProjectIssueCallback> &,
                           const std::set<std::string> &enableModules, bool deleteExisting);
 
         drogon::Task<service::Error> runIngestor() const;
+        // Parses and validates content data without touching the database
+        drogon::Task<service::Error> runPreparation() const;
+
+        // Records the duration of each ingestor phase
+        void setMetrics(service::DeploymentMetrics &metrics);
 
     private:
         drogon::Task<service::Error> ingestGameContentData() const;
+        void addSubModules(SubIngestors &ingestors, service::ProjectFileIssueCallback &issues) const;
+        drogon::Task<std::optional<PreparationResult>> prepareIngestors(const SubIngestors &ingestors, service::StageTimer &timer) const;
         bool enableModule(const std::string &name) const;
 
         template<typename T>
-        void addSubModule(std::vector<std::pair<std::string, std::unique_ptr<SubIngestor>>> &ingestors, const std::string &name,
-                          service::ProjectFileIssueCallback &issues) const {
+        void addSubModule(SubIngestors &ingestors, const std::string &name, service::ProjectFileIssueCallback &issues) const {
             if (enableModule(name)) {
                 ingestors.emplace_back(name, std::make_unique<T>(project_, logger_, issues));
             }
@@ -63,6 +100,7 @@ namespace content {
         std::shared_ptr<service::ProjectIssueCallback> issues_;
         const std::set<std::string> enableModules_;
         const bool deleteExisting_;
+        service::DeploymentMetrics *metrics_ = nullptr;
     };
 
     class ContentPathsSubIngestor final : public SubIngestor {
@@ -71,7 +109,7 @@ namespace content {
                                          service::ProjectFileIssueCallback &);
 
         drogon::Task<PreparationResult> prepare() override;
-        drogon::Task<service::Error> execute() override;
+        drogon::Task<service::Error> execute(const IngestedLocations &locations) override;
 
     private:
         std::unordered_map<std::string, std::string> pagePaths_;
@@ -83,7 +121,7 @@ namespace content {
                                  service::ProjectFileIssueCallback &);
 
         drogon::Task<PreparationResult> prepare() override;
-        drogon::Task<service::Error> execute() override;
+        drogon::Task<service::Error> execute(const IngestedLocations &locations) override;
         drogon::Task<service::Error> finish() override;
 
     private:
@@ -97,16 +135,13 @@ namespace content {
                                     service::ProjectFileIssueCallback &);
 
         drogon::Task<PreparationResult> prepare() override;
-        drogon::Task<service::Error> execute() override;
+        drogon::Task<service::Error> execute(const IngestedLocations &locations) override;
 
     private:
         std::optional<PreparedData<StubRecipeType>> readRecipeType(const std::string &namespace_, const std::filesystem::path &root,
                                                                    const std::filesystem::path &path) const;
-        drogon::Task<service::Error> addRecipeType(PreparedData<StubRecipeType> type) const;
-
         std::optional<PreparedData<StubRecipe>> readRecipe(const std::string &namespace_, const std::filesystem::path &root,
                                                            const std::filesystem::path &path) const;
-        drogon::Task<service::Error> addRecipe(PreparedData<StubRecipe> recipe) const;
 
         std::vector<PreparedData<StubRecipeType>> recipeTypes_;
         std::vector<PreparedData<StubRecipe>> recipes_;
@@ -118,7 +153,7 @@ namespace content {
                                      service::ProjectFileIssueCallback &);
 
         drogon::Task<PreparationResult> prepare() override;
-        drogon::Task<service::Error> execute() override;
+        drogon::Task<service::Error> execute(const IngestedLocations &locations) override;
 
     private:
         drogon::Task<service::Error> addWorkbenches(PreparedData<StubWorkbenches> workbenches) const;
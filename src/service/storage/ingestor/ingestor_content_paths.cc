@@ -24,16 +24,25 @@ namespace content {
         PreparationResult result;
 
         const auto contentRoot = project_.getFormat().getContentDirectoryPath();
-        for (const auto docsRoot = project_.getFormat().getRoot(); const auto &entry: fs::recursive_directory_iterator(docsRoot)) {
-            if (!shouldIncludeFile(contentRoot, entry)) {
-                continue;
+        const auto docsRoot = project_.getFormat().getRoot();
+
+        std::vector<fs::path> files;
+        for (const auto &entry: fs::recursive_directory_iterator(docsRoot)) {
+            if (shouldIncludeFile(contentRoot, entry)) {
+                files.push_back(entry.path());
             }
-            const auto relativePath = relative(entry.path(), docsRoot);
-            ProjectFileIssueCallback fileIssues{issues_, entry.path()};
+        }
+        std::ranges::sort(files);
+
+        // Reading frontmatter is independent per file, duplicates are resolved afterwards in path order
+        const auto attributes = co_await parallelMap(
+            files, [&](const fs::path &file) { return project_.readPageAttributes(relative(file, docsRoot).string()); });
 
-            if (const auto pageAttributes = project_.readPageAttributes(relativePath.string());
-                pageAttributes && !pageAttributes->id.empty())
-            {
+        for (size_t i = 0; i < files.size(); i++) {
+            const auto relativePath = relative(files[i], docsRoot);
+            ProjectFileIssueCallback fileIssues{issues_, files[i]};
+
+            if (const auto &pageAttributes = attributes[i]; pageAttributes && !pageAttributes->id.empty()) {
                 const auto id = pageAttributes->id;
                 if (pagePaths_.contains(id)) {
                     logger_->warn("Skipping duplicate page for item {} at {}", id, relativePath.string());
@@ -57,11 +66,16 @@ namespace content {
         co_return result;
     }
 
-    Task<Error> ContentPathsSubIngestor::execute() {
-        const auto clientPtr = app().getFastDbClient();
+    Task<Error> ContentPathsSubIngestor::execute(const IngestedLocations &locations) {
+        std::vector<std::pair<int64_t, std::string>> pages;
+        for (const auto &[id, path]: pagePaths_) {
+            if (const auto itemId = locations.items.find(id); itemId != locations.items.end()) {
+                pages.emplace_back(itemId->second, path);
+            }
+        }
 
-        for (auto &[id, path]: pagePaths_) {
-            co_await project_.getProjectDatabase().addProjectContentPage(id, path);
+        if (const auto result = co_await project_.getProjectDatabase().addProjectContentPages(pages); !result) {
+            co_return result.error();
         }
 
         co_return Error::Ok;
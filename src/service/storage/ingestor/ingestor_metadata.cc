@@ -46,7 +46,7 @@ namespace content {
         co_return Error::Ok;
     }
 
-    Task<Error> MetadataSubIngestor::execute() {
+    Task<Error> MetadataSubIngestor::execute(const IngestedLocations &) {
         logger_->info("Adding {} recipes workbenches", workbenches_.size());
 
         for (const auto &workbench: workbenches_) {
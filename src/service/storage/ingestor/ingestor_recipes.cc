@@ -3,7 +3,6 @@
 #include <drogon/drogon.h>
 #include <service/database/database.h>
 #include <service/database/project_database.h>
-#include <service/project/virtual/virtual.h>
 
 using namespace drogon;
 using namespace drogon::orm;
@@ -14,40 +13,51 @@ namespace content {
     RecipesSubIngestor::RecipesSubIngestor(const ProjectBase &proj, const std::shared_ptr<spdlog::logger> &log,
                                            ProjectFileIssueCallback &issues) : SubIngestor(proj, log, issues) {}
 
+    std::vector<fs::path> listJsonFiles(const fs::path &root) {
+        std::vector<fs::path> files;
+        for (const auto &entry: fs::recursive_directory_iterator(root)) {
+            if (entry.is_regular_file() && entry.path().extension() == EXT_JSON) {
+                files.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(files);
+        return files;
+    }
+
     Task<PreparationResult> RecipesSubIngestor::prepare() {
         PreparationResult result;
 
         const auto dataRoot = project_.getFormat().getDataRoot();
         const auto modid = project_.getProject().getValueOfModid();
 
+        // Files are parsed and validated in parallel, results are collected in path order
         if (const auto recipesRoot = dataRoot / modid / "recipe"; exists(recipesRoot)) {
-            for (const auto &entry: fs::recursive_directory_iterator(recipesRoot)) {
-                if (!entry.is_regular_file() || entry.path().extension() != EXT_JSON) {
-                    continue;
-                }
+            const auto files = listJsonFiles(recipesRoot);
+            const auto recipes = co_await parallelMap(files, [&](const fs::path &file) { return readRecipe(modid, recipesRoot, file); });
 
-                if (const auto recipe = readRecipe(modid, recipesRoot, entry.path())) {
+            for (size_t i = 0; i < files.size(); i++) {
+                if (const auto &recipe = recipes[i]) {
                     recipes_.push_back(*recipe);
 
-                    for (const auto &item: recipe->data.ingredients) {
-                        result.items.insert(item.itemId);
+                    for (const auto &ingredient: recipe->data.ingredients) {
+                        (ingredient.isTag ? result.tags : result.items).insert(ingredient.itemId);
                     }
                 } else {
-                    logger_->warn("Skipping recipe file: '{}'", entry.path().filename().string());
+                    logger_->warn("Skipping recipe file: '{}'", files[i].filename().string());
                 }
             }
         }
 
         if (const auto recipeTypesRoot = dataRoot / modid / "recipe_type"; exists(recipeTypesRoot)) {
-            for (const auto &entry: fs::recursive_directory_iterator(recipeTypesRoot)) {
-                if (!entry.is_regular_file() || entry.path().extension() != EXT_JSON) {
-                    continue;
-                }
+            const auto files = listJsonFiles(recipeTypesRoot);
+            const auto types =
+                co_await parallelMap(files, [&](const fs::path &file) { return readRecipeType(modid, recipeTypesRoot, file); });
 
-                if (const auto recipe = readRecipeType(modid, recipeTypesRoot, entry.path())) {
-                    recipeTypes_.push_back(*recipe);
+            for (size_t i = 0; i < files.size(); i++) {
+                if (const auto &type = types[i]) {
+                    recipeTypes_.push_back(*type);
                 } else {
-                    logger_->warn("Skipping recipe type file: '{}'", entry.path().filename().string());
+                    logger_->warn("Skipping recipe type file: '{}'", files[i].filename().string());
                 }
             }
         }
@@ -55,85 +65,47 @@ namespace content {
         co_return result;
     }
 
-    Task<Error> RecipesSubIngestor::addRecipeType(const PreparedData<StubRecipeType> type) const {
-        const auto clientPtr = project_.getProjectDatabase().getDbClientPtr();
-        const auto versionId = project_.getProjectVersion().getValueOfId();
-        CoroMapper<RecipeType> recipeTypeMapper(clientPtr);
+    Task<Error> RecipesSubIngestor::execute(const IngestedLocations &locations) {
+        const auto &db = project_.getProjectDatabase();
 
-        RecipeType dbType;
-        dbType.setVersionId(versionId);
-        dbType.setLoc(type.data.id);
-        co_await recipeTypeMapper.insert(dbType);
-
-        co_return Error::Ok;
-    }
+        logger_->info("Adding {} recipes types", recipeTypes_.size());
 
-    Task<Error> RecipesSubIngestor::addRecipe(const PreparedData<StubRecipe> recipe) const {
-        const auto clientPtr = project_.getProjectDatabase().getDbClientPtr();
-        CoroMapper<Recipe> recipeMapper(clientPtr);
-        CoroMapper<RecipeType> recipeTypeMapper(clientPtr);
+        std::vector<std::string> types;
+        for (const auto &type: recipeTypes_) {
+            types.push_back(type.data.id);
+        }
+        if (const auto result = co_await db.addRecipeTypes(types); !result) {
+            co_return result.error();
+        }
 
-        const auto [id, type, ingredients] = recipe.data;
-        const auto versionId = project_.getProjectVersion().getValueOfId();
+        logger_->info("Adding {} recipes", recipes_.size());
 
-        const TaskResult<RecipeType> recipeType = co_await project_.getProjectDatabase().getRecipeType(type) ||
-                                                  co_await global::virtualProject->getProjectDatabase().getRecipeType(type);
-        if (!recipeType) {
-            co_await recipe.issues.addIssue(ProjectIssueLevel::ERROR, ProjectIssueType::INGESTOR, ProjectError::UNKNOWN_RECIPE_TYPE, type);
-            co_return Error::ErrNotFound;
+        std::set<std::string> usedTypes;
+        for (const auto &recipe: recipes_) {
+            usedTypes.insert(recipe.data.type);
         }
+        const auto typeIds = co_await db.getRecipeTypeIds({usedTypes.begin(), usedTypes.end()});
 
-        Recipe dbRecipe;
-        dbRecipe.setVersionId(versionId);
-        dbRecipe.setLoc(id);
-        dbRecipe.setTypeId(recipeType->getValueOfId());
-        const auto insertedRecipe = co_await recipeMapper.insert(dbRecipe);
-        const auto recipeId = insertedRecipe.getValueOfId();
-
-        for (auto &[ingredientId, slot, count, input, isTag]: ingredients) {
-            try {
-                if (isTag) {
-                    // language=postgresql
-                    co_await clientPtr->execSqlCoro("INSERT INTO recipe_ingredient_tag (recipe_id, tag_id, slot, count, input) \
-                                                        SELECT $1 as recipe_id, id, $3 as slot, $4 as count, $5 as input \
-                                                        FROM tag \
-                                                        WHERE tag.loc = $2;",
-                                                    recipeId, ingredientId, slot, count, input);
-                } else {
-                    // language=postgresql
-                    co_await clientPtr->execSqlCoro("INSERT INTO recipe_ingredient_item (recipe_id, item_id, slot, count, input) \
-                                                        SELECT $1 as recipe_id, id, $3 as slot, $4 as count, $5 as input \
-                                                        FROM item \
-                                                        WHERE item.loc = $2;",
-                                                    recipeId, ingredientId, slot, count, input);
-                }
+        std::vector<IngestedRecipe> recipes;
+        for (const auto &recipe: recipes_) {
+            const auto typeId = typeIds.find(recipe.data.type);
+            if (typeId == typeIds.end()) {
+                co_await recipe.issues.addIssue(ProjectIssueLevel::ERROR, ProjectIssueType::INGESTOR, ProjectError::UNKNOWN_RECIPE_TYPE,
+                                                recipe.data.type);
                 continue;
-            } catch ([[maybe_unused]] const std::exception &e) {
-                const auto ingredientName = isTag ? "#" + ingredientId : ingredientId;
-                logger_->warn("Skipping recipe '{}' due to missing ingredient '{}'", id, ingredientName);
-                recipe.issues.addIssueAsync(ProjectIssueLevel::ERROR, ProjectIssueType::INGESTOR, ProjectError::INVALID_INGREDIENT,
-                                            ingredientName);
             }
-            co_await recipeMapper.deleteByPrimaryKey(recipeId);
-            co_return Error::ErrNotFound;
-        }
-
-        co_return Error::Ok;
-    }
-
-    Task<Error> RecipesSubIngestor::execute() {
-        logger_->info("Adding {} recipes types", recipeTypes_.size());
 
-        for (const auto &type: recipeTypes_) {
-            logger_->trace("Registering recipe type '{}'", type.data.id);
-            co_await addRecipeType(type);
+            IngestedRecipe ingested{.loc = recipe.data.id, .typeId = typeId->second};
+            for (const auto &[itemId, slot, count, input, isTag]: recipe.data.ingredients) {
+                const auto &ids = isTag ? locations.tags : locations.items;
+                if (const auto id = ids.find(itemId); id != ids.end()) {
+                    ingested.ingredients.push_back({.id = id->second, .slot = slot, .count = count, .input = input, .isTag = isTag});
+                }
+            }
+            recipes.push_back(std::move(ingested));
         }
-
-        logger_->info("Adding {} recipes", recipes_.size());
-
-        for (const auto &recipe: recipes_) {
-            logger_->trace("Registering recipe '{}'", recipe.data.id);
-            co_await addRecipe(recipe);
+        if (const auto result = co_await db.addRecipes(recipes); !result) {
+            co_return result.error();
         }
 
         co_return Error::Ok;
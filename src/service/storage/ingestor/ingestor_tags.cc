@@ -11,6 +11,16 @@ using namespace service;
 namespace fs = std::filesystem;
 
 namespace content {
+    struct TagFile {
+        std::string id;
+        fs::path path;
+    };
+
+    struct ParsedTag {
+        std::string id;
+        std::vector<std::string> values;
+    };
+
     TagsSubIngestor::TagsSubIngestor(const ProjectBase &proj, const std::shared_ptr<spdlog::logger> &log,
                                      ProjectFileIssueCallback &issues) : SubIngestor(proj, log, issues) {}
 
@@ -31,6 +41,8 @@ namespace content {
 
         projectLog.info("Ingesting item tags");
 
+        std::vector<TagFile> files;
+
         // [namespace]
         for (const auto &namespaceDir: fs::directory_iterator(dataRoot)) {
             if (!namespaceDir.is_directory()) {
@@ -65,91 +77,116 @@ namespace content {
                         continue;
                     }
 
-                    const ProjectFileIssueCallback fileIssues{issues_, tagFile};
-
                     const auto relativePath = relative(tagFile, tagTypeDir);
                     const auto fileName = relativePath.string();
                     const auto id = nmspace + ":" + fileName.substr(0, fileName.find_last_of('.'));
 
-                    if (!fileIssues.validateResourceLocation(id)) {
-                        continue;
-                    }
+                    files.push_back({.id = id, .path = tagFile.path()});
+                }
+            }
+        }
+        std::ranges::sort(files, {}, &TagFile::path);
 
-                    const auto json = fileIssues.readAndValidateJson(schemas::gameTag);
-                    if (!json) {
-                        continue;
-                    }
+        const auto tags = co_await parallelMap(files, [&](const TagFile &file) -> std::optional<ParsedTag> {
+            const ProjectFileIssueCallback fileIssues{issues_, file.path};
 
-                    tagIds_.insert(id);
-
-                    for (const auto values = (*json)["values"]; const auto &value: values) {
-                        std::string valueId;
-
-                        if (value.is_object()) {
-                            valueId = value["id"];
-                        } else if (value.is_string()) {
-                            valueId = value;
-                        } else {
-                            logger.error("Unexpected tag value format in {}: {}", tagFile.path().string(), value.dump());
-                            co_await fileIssues.addIssue(ProjectIssueLevel::ERROR, ProjectIssueType::INGESTOR, ProjectError::INVALID_FORMAT,
-                                                         std::format("Unexpected tag entry: {}", value.dump()));
-                            continue;
-                        }
-
-                        if (valueId.starts_with("#")) {
-                            tagIds_.insert(valueId);
-                        } else if (const auto resloc = ResourceLocation::parse(valueId); resloc && resloc->namespace_ == projectModid) {
-                            result.items.insert(valueId);
-                        }
-
-                        tagEntries_[id].insert(valueId);
-                    }
+            if (!fileIssues.validateResourceLocation(file.id)) {
+                return std::nullopt;
+            }
+
+            const auto json = fileIssues.readAndValidateJson(schemas::gameTag);
+            if (!json) {
+                return std::nullopt;
+            }
+
+            ParsedTag tag{.id = file.id};
+            for (const auto values = (*json)["values"]; const auto &value: values) {
+                if (value.is_object()) {
+                    tag.values.push_back(value["id"].get<std::string>());
+                } else if (value.is_string()) {
+                    tag.values.push_back(value.get<std::string>());
+                } else {
+                    logger.error("Unexpected tag value format in {}: {}", file.path.string(), value.dump());
+                    fileIssues.addIssueAsync(ProjectIssueLevel::ERROR, ProjectIssueType::INGESTOR, ProjectError::INVALID_FORMAT,
+                                             std::format("Unexpected tag entry: {}", value.dump()));
+                }
+            }
+            return tag;
+        });
+
+        for (const auto &tag: tags) {
+            if (!tag) {
+                continue;
+            }
+
+            tagIds_.insert(tag->id);
+            result.tags.insert(tag->id);
+
+            for (const auto &valueId: tag->values) {
+                if (valueId.starts_with("#")) {
+                    tagIds_.insert(valueId);
+                    result.tags.insert(valueId.substr(1));
+                } else {
+                    result.items.insert(valueId);
                 }
+
+                tagEntries_[tag->id].insert(valueId);
             }
         }
 
         co_return result;
     }
 
-    Task<Error> TagsSubIngestor::execute() {
-        const auto projectModid = project_.getProject().getValueOfModid();
+    Task<Error> TagsSubIngestor::execute(const IngestedLocations &locations) {
         auto projectLog = *logger_;
 
         projectLog.debug("Registering {} tags", tagIds_.size());
 
+        std::vector<int64_t> tags;
         for (const auto &tag: tagIds_) {
-            if (const auto resloc = ResourceLocation::parse(tag); !resloc) {
-                continue;
+            if (const auto id = locations.tags.find(tag); id != locations.tags.end()) {
+                tags.push_back(id->second);
             }
-
-            projectLog.trace("Registering tag '{}'", tag);
-            co_await project_.getProjectDatabase().addTag(tag);
+        }
+        if (const auto result = co_await project_.getProjectDatabase().addTags(tags); !result) {
+            co_return result.error();
         }
 
         projectLog.debug("Registering tag entries");
 
+        std::vector<std::pair<int64_t, int64_t>> tagEntries;
+        std::vector<std::pair<int64_t, int64_t>> itemEntries;
         for (const auto &[key, val]: tagEntries_) {
+            const auto parent = locations.tags.find(key);
+            if (parent == locations.tags.end()) {
+                continue;
+            }
             for (auto &entry: val) {
-                const auto isTag = entry.starts_with("#");
-                const auto entryId = isTag ? entry.substr(1) : entry;
-
-                if (isTag) {
-                    const auto tagId = entry.substr(1);
-                    co_await project_.getProjectDatabase().addTagTagEntry(key, tagId);
-                } else {
-                    co_await project_.getProjectDatabase().addTagItemEntry(key, entry);
+                if (entry.starts_with("#")) {
+                    if (const auto child = locations.tags.find(entry.substr(1)); child != locations.tags.end()) {
+                        tagEntries.emplace_back(parent->second, child->second);
+                    }
+                } else if (const auto item = locations.items.find(entry); item != locations.items.end()) {
+                    itemEntries.emplace_back(parent->second, item->second);
                 }
             }
         }
+        if (const auto result = co_await project_.getProjectDatabase().addTagTagEntries(tagEntries); !result) {
+            co_return result.error();
+        }
+        if (const auto result = co_await project_.getProjectDatabase().addTagItemEntries(itemEntries); !result) {
+            co_return result.error();
+        }
 
         co_return Error::Ok;
     }
 
     Task<Error> TagsSubIngestor::finish() {
         if (tagIds_.size() > 0) {
-            logger.debug("Refreshing flat tag->item view after data ingestion");
-            const Database transDb{project_.getProjectDatabase().getDbClientPtr()};
-            co_await transDb.refreshFlatTagItemView();
+            logger.debug("Refreshing flat tag->item entries after data ingestion");
+            if (const auto result = co_await project_.getProjectDatabase().refreshFlatTagItems(); !result) {
+                co_return result.error();
+            }
         }
         co_return Error::Ok;
     }
@@ -2,6 +2,8 @@
 
 #include "issue_service.h"
 
+#include <drogon/drogon.h>
+
 using namespace drogon;
 
 namespace service {
@@ -33,8 +35,8 @@ namespace service {
         if (level == ProjectIssueLevel::ERROR)
             hasErrors_ = true;
 
-        const auto currentLoop = trantor::EventLoop::getEventLoopOfCurrentThread();
-        currentLoop->queueInLoop(
+        // Issues may be reported from worker and file IO threads, whose loops own no database client
+        app().getLoop()->queueInLoop(
             async_func([level, type, subject, details, file, deploymentId = std::string(deploymentId_), logger = logger_]() -> Task<> {
                 co_await addIssueStatic(level, type, subject, details, file, deploymentId, logger);
             }));
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <service/project/project.h>
 
 namespace service {
@@ -19,7 +20,7 @@ namespace service {
         const std::string deploymentId_;
         const std::shared_ptr<spdlog::logger> logger_;
 
-        bool hasErrors_;
+        std::atomic<bool> hasErrors_;
     };
 
     class ProjectFileIssueCallback {
@@ -40,7 +40,8 @@ namespace service {
         {ProjectError::MISSING_PLATFORM_PROJECT, "missing_platform_project"},
         {ProjectError::NO_PAGE_TITLE, "no_page_title"},
         {ProjectError::INVALID_FRONTMATTER, "invalid_frontmatter"},
-        {ProjectError::MISSING_REQUIRED_ATTRIBUTE, "missing_required_attribute"}
+        {ProjectError::MISSING_REQUIRED_ATTRIBUTE, "missing_required_attribute"},
+        {ProjectError::CANCELLED, "cancelled"}
     )
     // clang-format on
 }
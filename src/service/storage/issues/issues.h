@@ -20,6 +20,7 @@ namespace service {
         INVALID_FILE, INVALID_FORMAT, INVALID_RESLOC, INVALID_VERSION_BRANCH,
         INVALID_FRONTMATTER,
         MISSING_PLATFORM_PROJECT, NO_PAGE_TITLE, MISSING_REQUIRED_ATTRIBUTE,
+        CANCELLED,
         UNKNOWN
     };
     // clang-format on
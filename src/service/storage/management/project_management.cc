@@ -4,9 +4,8 @@
 
 #include <service/database/database.h>
 #include <service/error.h>
-#include <service/external/frontend.h>
-#include <service/project/cached/cached.h>
 #include <service/util.h>
+#include <storage/deployment_queue.h>
 #include <storage/storage.h>
 #include <util/crypto.h>
 
@@ -195,19 +194,11 @@ namespace service {
         co_return ValidatedProjectData{.project = project, .platforms = platforms};
     }
 
-    void enqueueDeploy(const Project &project, const std::string &userId) {
+    void enqueueDeploy(const Project &project, const std::string &userId, const DeploymentPriority priority) {
         const auto currentLoop = trantor::EventLoop::getEventLoopOfCurrentThread();
-        currentLoop->queueInLoop(async_func([project, userId]() -> Task<> {
-            logger.debug("Deploying project '{}' from branch '{}'", project.getValueOfId(), project.getValueOfSourceBranch());
-
-            if (const auto result = co_await global::storage->deployProject(project, userId); result) {
-                logger.debug("Project '{}' deployed successfully", project.getValueOfId());
-
-                co_await clearProjectCache(project.getValueOfId());
-                co_await global::frontend->revalidateProject(project.getValueOfId());
-            } else {
-                logger.error("Encountered error while deploying project '{}'", project.getValueOfId());
-            }
+        currentLoop->queueInLoop(async_func([project, userId, priority]() -> Task<> {
+            logger.debug("Queueing deployment of project '{}'", project.getValueOfId());
+            co_await global::deployments->enqueue(project, userId, priority);
         }));
     }
 }
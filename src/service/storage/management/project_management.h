@@ -4,6 +4,8 @@
 #include <models/Project.h>
 #include <nlohmann/json.hpp>
 #include <service/platforms.h>
+#include <service/util.h>
+#include <service/storage/deployment.h>
 
 using namespace drogon_model::postgres;
 
@@ -20,5 +22,5 @@ namespace service {
 
     drogon::Task<ValidatedProjectData> validateProjectData(nlohmann::json json, User user, bool checkExisting, bool localEnv);
 
-    void enqueueDeploy(const Project &project, const std::string &userId);
+    void enqueueDeploy(const Project &project, const std::string &userId, DeploymentPriority priority = DeploymentPriority::MANUAL);
 }
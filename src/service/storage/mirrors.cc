@@ -0,0 +1,145 @@
+#include "mirrors.h"
+
+#include <git2/odb.h>
+#include <git2/oid.h>
+#include <log/log.h>
+#include <ranges>
+#include <service/storage/gitops.h>
+
+#define MAX_MIRROR_SIZE_BYTES 1024 * 1024 * 1024
+
+using namespace logging;
+namespace fs = std::filesystem;
+
+namespace service {
+    std::string getMirrorName(const std::string &url) {
+        git_oid oid;
+        git_odb_hash(&oid, url.data(), url.size(), GIT_OBJECT_BLOB);
+
+        char hash[GIT_OID_HEXSZ + 1] = {};
+        git_oid_fmt(hash, &oid);
+        return std::string(hash) + ".git";
+    }
+
+    uintmax_t getDirectorySize(const fs::path &path) {
+        uintmax_t size = 0;
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec)) {
+                size += it->file_size(ec);
+            }
+        }
+        return size;
+    }
+
+    MirrorCache::MirrorCache(const fs::path &root, const uintmax_t budget, const Trash &trash) :
+        root_(root), budget_(budget), trash_(trash) {
+        create_directories(root_);
+
+        // Restore usage information of mirrors kept from previous runs
+        for (const auto &entry: fs::directory_iterator(root_)) {
+            if (!entry.is_directory()) {
+                continue;
+            }
+            const auto mirror = std::make_shared<Mirror>();
+            mirror->size = getDirectorySize(entry.path());
+            mirror->lastUsed = entry.last_write_time();
+            mirrors_.emplace(entry.path().filename().string(), mirror);
+        }
+    }
+
+    std::shared_ptr<MirrorCache::Mirror> MirrorCache::acquire(const std::string &name) const {
+        std::lock_guard lock(mutex_);
+        auto &mirror = mirrors_[name];
+        if (!mirror) {
+            mirror = std::make_shared<Mirror>();
+        }
+        mirror->users++;
+        return mirror;
+    }
+
+    void MirrorCache::release(const std::string &name, const std::shared_ptr<Mirror> &mirror) const {
+        const auto now = fs::file_time_type::clock::now();
+        std::error_code ec;
+        fs::last_write_time(root_ / name, now, ec);
+
+        std::lock_guard lock(mutex_);
+        mirror->lastUsed = now;
+        mirror->users--;
+    }
+
+    void MirrorCache::evict() const {
+        std::lock_guard lock(mutex_);
+
+        uintmax_t total = 0;
+        for (const auto &mirror: mirrors_ | std::views::values) {
+            total += mirror->size;
+        }
+
+        while (total > budget_) {
+            // Mirrors in use are never evicted
+            auto oldest = mirrors_.end();
+            for (auto it = mirrors_.begin(); it != mirrors_.end(); ++it) {
+                if (it->second->users == 0 && (oldest == mirrors_.end() || it->second->lastUsed < oldest->second->lastUsed)) {
+                    oldest = it;
+                }
+            }
+            if (oldest == mirrors_.end()) {
+                break;
+            }
+
+            logger.debug("Evicting repository mirror {} ({} MiB)", oldest->first, oldest->second->size / 1024 / 1024);
+            trash_.retire(root_ / oldest->first);
+            total -= oldest->second->size;
+            mirrors_.erase(oldest);
+        }
+    }
+
+    std::tuple<git_repository *, ProjectErrorInstance> MirrorCache::cloneRepository(const std::string &url, const fs::path &dest,
+                                                                                    const std::string &branch, const std::string &sparsePath,
+                                                                                    const std::shared_ptr<spdlog::logger> &logger,
+                                                                                    size_t *receivedBytes) const {
+        // Local repositories are already cheap to clone
+        if (budget_ == 0 || git::is_local_url(url)) {
+            return git::cloneRepository(url, dest, branch, sparsePath, logger, receivedBytes);
+        }
+
+        const auto name = getMirrorName(url);
+        const auto path = root_ / name;
+        const auto mirror = acquire(name);
+
+        std::tuple<git_repository *, ProjectErrorInstance> result;
+        {
+            // Deployments of projects sharing a repository take turns updating the mirror
+            std::lock_guard lock(mirror->mutex);
+
+            logger->info("Updating mirror of git repository at {}", url);
+            const auto created = !exists(path);
+            if (const auto error = git::fetchMirror(url, path, logger, receivedBytes); error.error != ProjectError::OK) {
+                // A failed first fetch leaves behind an empty repository that would be mistaken for a mirror
+                if (created) {
+                    trash_.retire(path);
+                }
+                result = {nullptr, error};
+            } else {
+                result = git::cloneFromMirror(path, dest, branch, sparsePath, logger);
+            }
+
+            // Objects of previous branch tips accumulate with each fetch, an oversized mirror is fetched anew next time
+            auto size = getDirectorySize(path);
+            if (size > MAX_MIRROR_SIZE_BYTES) {
+                logger->info("Repository mirror grew to {} MiB, discarding it", size / 1024 / 1024);
+                trash_.retire(path);
+                size = 0;
+            }
+
+            std::lock_guard registryLock(mutex_);
+            mirror->size = size;
+        }
+
+        release(name, mirror);
+        evict();
+
+        return result;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <drogon/utils/coroutine.h>
+#include <filesystem>
+#include <git2/types.h>
+#include <mutex>
+#include <service/project/resolved.h>
+#include <service/storage/trash.h>
+#include <spdlog/spdlog.h>
+#include <unordered_map>
+
+namespace service {
+    // Bare mirrors of remote repositories, kept between deployments.
+    // Each deployment only fetches objects that are missing from the mirror and then clones locally from it.
+    // The least recently used mirrors are evicted once the cache grows past its disk budget.
+    class MirrorCache {
+    public:
+        MirrorCache(const std::filesystem::path &root, uintmax_t budget, const Trash &trash);
+
+        // Blocks while another deployment uses the same mirror, callers run it off the event loops
+        std::tuple<git_repository *, ProjectErrorInstance> cloneRepository(const std::string &url, const std::filesystem::path &dest,
+                                                                           const std::string &branch, const std::string &sparsePath,
+                                                                           const std::shared_ptr<spdlog::logger> &logger,
+                                                                           size_t *receivedBytes = nullptr) const;
+
+    private:
+        struct Mirror {
+            // Held while the mirror is fetched into or cloned from
+            std::mutex mutex;
+            size_t users = 0;
+            uintmax_t size = 0;
+            std::filesystem::file_time_type lastUsed;
+        };
+
+        std::shared_ptr<Mirror> acquire(const std::string &name) const;
+        void release(const std::string &name, const std::shared_ptr<Mirror> &mirror) const;
+        void evict() const;
+
+        const std::filesystem::path root_;
+        const uintmax_t budget_;
+        const Trash &trash_;
+        mutable std::mutex mutex_;
+        mutable std::unordered_map<std::string, std::shared_ptr<Mirror>> mirrors_;
+    };
+}
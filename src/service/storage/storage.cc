@@ -3,11 +3,15 @@
 #include <fstream>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <service/file_io.h>
 #include <service/project/virtual/virtual.h>
 #include <service/util.h>
 
 #define LATEST_VERSION "latest"
 #define LOG_FILE "project.log"
+#define BLOBS_DIR ".blobs"
+#define TRASH_DIR ".trash"
+#define MIRRORS_DIR ".mirrors"
 
 using namespace logging;
 using namespace drogon;
@@ -26,7 +30,9 @@ namespace service {
     )
     // clang-format on
 
-    Storage::Storage(const std::string &basePath) : basePath_(basePath) {
+    Storage::Storage(const std::string &basePath, const bool bundles, const uintmax_t mirrorCacheSize) :
+        basePath_(basePath), bundleFormat_(bundles), blobs_(fs::path(basePath) / BLOBS_DIR), trash_(fs::path(basePath) / TRASH_DIR, blobs_),
+        mirrors_(fs::path(basePath) / MIRRORS_DIR, mirrorCacheSize, trash_) {
         if (!fs::exists(basePath_)) {
             fs::create_directories(basePath_);
         }
@@ -115,8 +121,18 @@ namespace service {
             co_return Error::ErrNotFound;
         }
 
-        const auto rootDir = getDeploymentVersionedDir(*activeDeployment, version.value_or(""));
-        if (!exists(rootDir)) {
+        // Checking the deployment and loading its files on first use touches the disk
+        const auto versionName = version.value_or("");
+        const auto rootDir = getDeploymentVersionedDir(*activeDeployment, versionName);
+        const auto [found, metadata, bundle] = co_await supplyFileIO<
+            std::tuple<bool, std::shared_ptr<const ProjectMetadata>, std::shared_ptr<const DeploymentBundle>>>(
+            [&]() -> std::tuple<bool, std::shared_ptr<const ProjectMetadata>, std::shared_ptr<const DeploymentBundle>> {
+                if (!exists(rootDir)) {
+                    return {false, nullptr, nullptr};
+                }
+                return {true, getDeploymentMetadata(*activeDeployment, versionName), getDeploymentBundle(*activeDeployment, versionName)};
+            });
+        if (!found) {
             co_return Error::ErrNotFound;
         }
 
@@ -131,6 +147,8 @@ namespace service {
                 std::make_shared<ProjectIssueCallback>(activeDeployment->getValueOfId(), getDeploymentLogger(*activeDeployment));
             ResolvedProject resolved{project, rootDir, *resolvedVersion, issues, logger};
             resolved.setLocale(locale);
+            resolved.setMetadata(metadata);
+            resolved.setBundle(bundle);
             co_return resolved;
         }
 
@@ -144,6 +162,8 @@ namespace service {
         const auto logger = getProjectLogger(project, false);
         ResolvedProject resolved{project, rootDir, *defaultVersion, issues, logger};
         resolved.setLocale(locale);
+        resolved.setMetadata(metadata);
+        resolved.setBundle(bundle);
         co_return resolved;
     }
 
@@ -189,14 +209,74 @@ namespace service {
         logger.debug("Deleting deployment dir '{}'", deployment.getValueOfId());
 
         const auto path = getDeploymentRootDir(deployment);
-        remove_all(path);
+        trash_.retire(path);
+        evictDeploymentCaches(deployment);
+    }
+
+    void Storage::recoverRemovedFiles() const { trash_.recover(); }
+
+    std::shared_ptr<const ProjectMetadata> Storage::getDeploymentMetadata(const Deployment &deployment, const std::string &version) const {
+        const auto rootDir = getDeploymentVersionedDir(deployment, version);
+        const auto key = rootDir.string();
+
+        {
+            std::shared_lock lock(metadataMutex_);
+            if (const auto it = metadata_.find(key); it != metadata_.end()) {
+                return it->second;
+            }
+        }
+
+        // Deployment files are immutable, so the metadata only needs to be parsed once.
+        // Failed loads are retried, as they may come from reading the files while they were still being written.
+        const auto metadata = std::make_shared<const ProjectMetadata>(loadProjectMetadata(V0ProjectFormat{rootDir, ""}));
+        if (metadata->error != ProjectError::OK) {
+            return metadata;
+        }
+
+        std::unique_lock lock(metadataMutex_);
+        return metadata_.try_emplace(key, metadata).first->second;
+    }
+
+    std::shared_ptr<const DeploymentBundle> Storage::getDeploymentBundle(const Deployment &deployment, const std::string &version) const {
+        if (!bundleFormat_) {
+            return nullptr;
+        }
+
+        const auto rootDir = getDeploymentVersionedDir(deployment, version);
+        const auto key = rootDir.string();
+
+        {
+            std::shared_lock lock(bundlesMutex_);
+            if (const auto it = bundles_.find(key); it != bundles_.end()) {
+                return it->second;
+            }
+        }
+
+        // Deployments made before bundles were enabled have none, which is remembered as well
+        const auto bundle = DeploymentBundle::open(DeploymentBundle::getPath(rootDir));
+
+        std::unique_lock lock(bundlesMutex_);
+        return bundles_.try_emplace(key, bundle).first->second;
+    }
+
+    void Storage::evictDeploymentCaches(const Deployment &deployment) const {
+        const auto prefix = (getDeploymentRootDir(deployment) / "").string();
+        const auto matches = [&prefix](const auto &entry) { return entry.first.starts_with(prefix); };
+
+        {
+            std::unique_lock lock(metadataMutex_);
+            std::erase_if(metadata_, matches);
+        }
+
+        std::unique_lock lock(bundlesMutex_);
+        std::erase_if(bundles_, matches);
     }
 
     Error Storage::invalidateProject(const Project &project) const {
         logger.debug("Invalidating project '{}'", project.getValueOfId());
 
         const auto basePath = getBaseDir().path() / project.getValueOfId();
-        remove_all(basePath);
+        trash_.retire(basePath);
 
         return Error::Ok;
     }
@@ -206,29 +286,63 @@ namespace service {
             co_return ProjectStatus::LOADING;
         }
 
-        if (const auto resolved = co_await maybeGetProject(project); !resolved) {
+        const auto summary = co_await global::database->getProjectSummary(project.getValueOfId());
+        if (!summary) {
             co_return ProjectStatus::UNKNOWN;
         }
 
-        if (co_await global::database->hasFailingDeployment(project.getValueOfId())) {
-            co_return ProjectStatus::AT_RISK;
+        co_return co_await getProjectStatus(project, *summary);
+    }
+
+    Task<ProjectStatus> Storage::getProjectStatus(const Project &project, const ProjectSummary &summary) const {
+        if (hasPendingTask(createProjectSetupKey(project))) {
+            co_return ProjectStatus::LOADING;
         }
 
-        if (const auto issues = co_await global::database->getActiveProjectIssueStats(project.getValueOfId());
-            issues.contains(enumToStr(ProjectIssueLevel::ERROR)))
-        {
+        if (!summary.active_deployment_id) {
+            co_return ProjectStatus::UNKNOWN;
+        }
+
+        // Like resolving the project, an active deployment only counts once its default version is on disk
+        const auto rootDir = getBaseDir().path() / project.getValueOfId() / *summary.active_deployment_id / LATEST_VERSION;
+        if (!co_await supplyFileIO<bool>([&] { return exists(rootDir); })) {
+            co_return ProjectStatus::UNKNOWN;
+        }
+
+        if (summary.has_failing_deployment || summary.issue_stats.contains(enumToStr(ProjectIssueLevel::ERROR))) {
             co_return ProjectStatus::AT_RISK;
         }
 
         co_return ProjectStatus::HEALTHY;
     }
 
-    Task<TaskResult<Deployment>> Storage::deployProject(const Project &project, const std::string userId) {
+    void Storage::cancelDeployment(const Project &project) const {
+        if (!hasPendingTask(createProjectSetupKey(project))) {
+            return;
+        }
+
+        logger.debug("Requesting cancellation of running deployment for project '{}'", project.getValueOfId());
+        std::lock_guard lock(cancelledMutex_);
+        cancelled_.insert(project.getValueOfId());
+    }
+
+    bool Storage::isDeploymentCancelled(const Project &project) const {
+        std::lock_guard lock(cancelledMutex_);
+        return cancelled_.contains(project.getValueOfId());
+    }
+
+    void Storage::clearDeploymentCancelled(const Project &project) const {
+        std::lock_guard lock(cancelledMutex_);
+        cancelled_.erase(project.getValueOfId());
+    }
+
+    Task<TaskResult<Deployment>> Storage::deployProject(const Project &project, const std::string userId,
+                                                        trantor::EventLoop *workerLoop) {
         if (hasPendingTask(createProjectSetupKey(project))) {
             co_return Error::ErrInternal;
         }
 
-        const auto [deployment, error] = co_await deployProjectCached(project, userId);
+        const auto [deployment, error] = co_await deployProjectCached(project, userId, workerLoop);
         if (error != ProjectError::OK) {
             co_return Error::ErrInternal;
         }
@@ -5,7 +5,14 @@
 #include <service/cache.h>
 #include <service/error.h>
 #include <service/project/resolved.h>
+#include <service/storage/blobs.h>
+#include <service/storage/bundle.h>
+#include <service/storage/deployment.h>
+#include <service/storage/mirrors.h>
 #include <service/storage/realtime.h>
+#include <service/storage/trash.h>
+#include <shared_mutex>
+#include <unordered_set>
 
 using namespace drogon_model::postgres;
 
@@ -17,7 +24,7 @@ namespace service {
 
     class Storage : public CacheableServiceBase {
     public:
-        explicit Storage(const std::string &);
+        Storage(const std::string &, bool bundles, uintmax_t mirrorCacheSize);
 
         drogon::Task<TaskResult<ProjectBasePtr>> getProject(std::string projectId, const std::optional<std::string> &version,
                                                                           const std::optional<std::string> &locale) const;
@@ -27,20 +34,27 @@ namespace service {
 
         [[maybe_unused]] Error invalidateProject(const Project &project) const;
         void removeDeployment(const Deployment &deployment) const;
+        void recoverRemovedFiles() const;
 
         drogon::Task<ProjectStatus> getProjectStatus(const Project &project) const;
+        drogon::Task<ProjectStatus> getProjectStatus(const Project &project, const ProjectSummary &summary) const;
 
         drogon::Task<std::tuple<std::optional<nlohmann::json>, ProjectError, std::string>>
         setupValidateTempProject(const Project &project) const;
 
-        drogon::Task<TaskResult<Deployment>> deployProject(const Project &project, std::string userId);
+        // Blocking deployment stages run on the worker loop, database queries stay on the calling IO loop
+        drogon::Task<TaskResult<Deployment>> deployProject(const Project &project, std::string userId, trantor::EventLoop *workerLoop);
+        void cancelDeployment(const Project &project) const;
 
         std::shared_ptr<spdlog::logger> getProjectLogger(const Project &project, bool file = true) const;
     private:
         drogon::Task<TaskResult<ProjectVersion>> getDefaultVersion(const Project &project) const;
 
-        drogon::Task<ProjectError> deployProject(const Project &project, Deployment &deployment, std::filesystem::path clonePath) const;
-        drogon::Task<std::tuple<std::optional<Deployment>, ProjectError>> deployProjectCached(const Project &project, std::string userId);
+        drogon::Task<ProjectError> deployProject(const Project &project, Deployment &deployment, std::filesystem::path clonePath,
+                                                 std::optional<Deployment> previous, trantor::EventLoop *workerLoop,
+                                                 DeploymentMetrics &metrics) const;
+        drogon::Task<std::tuple<std::optional<Deployment>, ProjectError>> deployProjectCached(const Project &project, std::string userId,
+                                                                                      trantor::EventLoop *workerLoop);
 
         drogon::Task<TaskResult<ResolvedProject>> findProject(const Project &project, const std::optional<std::string> &version,
                                                               const std::optional<std::string> &locale) const;
@@ -49,9 +63,27 @@ namespace service {
         std::filesystem::path getDeploymentRootDir(const Deployment &deployment) const;
         std::filesystem::path getDeploymentVersionedDir(const Deployment &deployment, const std::string &version = "") const;
         std::shared_ptr<spdlog::logger> getDeploymentLogger(const Deployment &deployment) const;
+        std::shared_ptr<const ProjectMetadata> getDeploymentMetadata(const Deployment &deployment, const std::string &version = "") const;
+        std::shared_ptr<const DeploymentBundle> getDeploymentBundle(const Deployment &deployment, const std::string &version = "") const;
+        void evictDeploymentCaches(const Deployment &deployment) const;
+        bool isDeploymentCancelled(const Project &project) const;
+        void clearDeploymentCancelled(const Project &project) const;
         std::shared_ptr<spdlog::logger> getProjectLoggerImpl(const std::string &id, const std::optional<std::filesystem::path> &file) const;
 
         const std::string &basePath_;
+        const bool bundleFormat_;
+        const BlobStore blobs_;
+        const Trash trash_;
+        const MirrorCache mirrors_;
+        // Validated project metadata, keyed by deployment version directory
+        mutable std::shared_mutex metadataMutex_;
+        mutable std::unordered_map<std::string, std::shared_ptr<const ProjectMetadata>> metadata_;
+        // Mapped deployment bundles, keyed by deployment version directory
+        mutable std::shared_mutex bundlesMutex_;
+        mutable std::unordered_map<std::string, std::shared_ptr<const DeploymentBundle>> bundles_;
+        // Projects whose running deployment should stop at the next checkpoint
+        mutable std::mutex cancelledMutex_;
+        mutable std::unordered_set<std::string> cancelled_;
     };
 }
 
@@ -0,0 +1,130 @@
+#include "trash.h"
+
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <log/log.h>
+
+// Number of files removed before pausing
+#define DELETE_BATCH_SIZE 256
+#define DELETE_BATCH_PAUSE std::chrono::milliseconds(10)
+
+using namespace logging;
+namespace fs = std::filesystem;
+
+namespace service {
+    Trash::Trash(const fs::path &root, const BlobStore &blobs) :
+        root_(root), blobs_(blobs), pending_(false), worker_([this](const std::stop_token &token) { run(token); }) {
+        create_directories(root_);
+    }
+
+    void Trash::retire(const fs::path &path) const {
+        static std::atomic<uint64_t> counter;
+
+        std::error_code ec;
+        if (!exists(path, ec)) {
+            return;
+        }
+
+        const auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        const auto target = root_ / std::format("{}-{}-{}", path.filename().string(), now, counter++);
+        fs::rename(path, target, ec);
+        if (ec) {
+            // Not on the same filesystem, fall back to deleting in place
+            logger.warn("Failed to move '{}' to trash, deleting immediately: {}", path.string(), ec.message());
+            remove_all(path, ec);
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            pending_ = true;
+        }
+        wakeup_.notify_one();
+    }
+
+    void Trash::recover() const {
+        std::error_code ec;
+        if (fs::is_empty(root_, ec) || ec) {
+            return;
+        }
+
+        logger.info("Resuming deletion of leftover files in trash");
+        {
+            std::lock_guard lock(mutex_);
+            pending_ = true;
+        }
+        wakeup_.notify_one();
+    }
+
+    void Trash::run(const std::stop_token &token) const {
+        while (!token.stop_requested()) {
+            {
+                std::unique_lock lock(mutex_);
+                if (!wakeup_.wait(lock, token, [this] { return pending_; })) {
+                    return;
+                }
+                pending_ = false;
+            }
+
+            std::vector<fs::path> entries;
+            try {
+                for (const auto &entry: fs::directory_iterator(root_)) {
+                    entries.push_back(entry.path());
+                }
+            } catch (std::exception &e) {
+                logger.error("Error listing trash contents: {}", e.what());
+                continue;
+            }
+
+            bool removed = false;
+            for (const auto &entry: entries) {
+                if (!purge(entry, token)) {
+                    return;
+                }
+                removed = true;
+            }
+
+            // Blobs are no longer referenced once the last deployment file linking them is gone
+            if (removed) {
+                blobs_.collectGarbage();
+            }
+        }
+    }
+
+    bool Trash::purge(const fs::path &entry, const std::stop_token &token) const {
+        logger.debug("Deleting '{}' from trash", entry.filename().string());
+
+        try {
+            std::vector<fs::path> files;
+            std::vector<fs::path> dirs;
+            for (const auto &child: fs::recursive_directory_iterator(entry)) {
+                (child.is_directory() && !child.is_symlink() ? dirs : files).push_back(child.path());
+            }
+
+            size_t batch = 0;
+            for (const auto &file: files) {
+                std::error_code ec;
+                remove(file, ec);
+
+                if (++batch == DELETE_BATCH_SIZE) {
+                    batch = 0;
+                    if (token.stop_requested()) {
+                        return false;
+                    }
+                    std::this_thread::sleep_for(DELETE_BATCH_PAUSE);
+                }
+            }
+
+            // Deepest directories come last in traversal order
+            for (auto it = dirs.rbegin(); it != dirs.rend(); ++it) {
+                std::error_code ec;
+                remove(*it, ec);
+            }
+            remove_all(entry);
+        } catch (std::exception &e) {
+            logger.error("Error deleting '{}' from trash: {}", entry.filename().string(), e.what());
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <service/storage/blobs.h>
+#include <thread>
+
+namespace service {
+    // Deletes retired directory trees in the background.
+    // Trees are first renamed into the trash directory, which is atomic on the same filesystem,
+    // and then removed file by file at a throttled pace so that deployments are not held up by disk I/O.
+    class Trash {
+    public:
+        Trash(const std::filesystem::path &root, const BlobStore &blobs);
+
+        void retire(const std::filesystem::path &path) const;
+        void recover() const;
+
+    private:
+        void run(const std::stop_token &token) const;
+        bool purge(const std::filesystem::path &entry, const std::stop_token &token) const;
+
+        const std::filesystem::path root_;
+        const BlobStore &blobs_;
+        mutable std::mutex mutex_;
+        mutable std::condition_variable_any wakeup_;
+        mutable bool pending_;
+        std::jthread worker_;
+    };
+}
@@ -167,16 +167,25 @@ namespace service {
 
     Task<> registerItems(const ProjectDatabaseAccess &db, const fs::path itemsRoot) {
         logger.debug("Registering all game items by asset files");
-        int count = 0;
+        std::vector<std::string> items;
         for (const auto &entry: fs::directory_iterator(itemsRoot)) {
             const auto name = entry.path().filename().string();
-            const auto id = "minecraft:" + name.substr(0, name.size() - 5);
-            if (const auto res = co_await db.addProjectItem(id); !res) {
-                logger.error("Failed to register game item: {}", id);
-            }
-            count++;
+            items.push_back("minecraft:" + name.substr(0, name.size() - 5));
+        }
+        const auto ids = co_await db.upsertItems(items);
+        if (!ids) {
+            logger.error("Failed to register game items");
+            co_return;
+        }
+        std::vector<int64_t> itemIds;
+        for (const auto &id: *ids | std::views::values) {
+            itemIds.push_back(id);
+        }
+        if (const auto res = co_await db.addProjectItems(itemIds); !res) {
+            logger.error("Failed to register game items");
+            co_return;
         }
-        logger.debug("Registered {} items", count);
+        logger.debug("Registered {} items", items.size());
     }
 
     Task<TaskResult<VersionManifest>> resolveLatestGameVersionManifest() {
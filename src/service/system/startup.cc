@@ -7,6 +7,10 @@ using namespace drogon;
 using namespace logging;
 
 namespace service {
+    // Requests that resolved a version before it was replaced may still be reading its content
+    constexpr std::chrono::minutes RETIRED_VERSION_GRACE_PERIOD{5};
+    constexpr std::chrono::minutes VERSION_VACUUM_INTERVAL{10};
+
     Task<> cleanupLoadingDeployments() {
         const auto deployments = co_await global::database->getLoadingDeployments();
         if (!deployments.empty()) {
@@ -17,5 +21,23 @@ namespace service {
         }
 
         co_await global::database->failLoadingDeployments();
+
+        // Finish deleting files left over from an interrupted run
+        global::storage->recoverRemovedFiles();
+
+        // Content staged by interrupted deployments will never be activated
+        co_await global::database->retireStagingVersions();
+    }
+
+    Task<> vacuumRetiredVersions() {
+        if (const auto result = co_await global::database->deleteRetiredVersions(RETIRED_VERSION_GRACE_PERIOD); !result) {
+            logger.error("Failed to delete retired project versions");
+        } else if (*result > 0) {
+            logger.debug("Deleted {} retired project versions", *result);
+        }
+    }
+
+    void scheduleVersionVacuum() {
+        app().getLoop()->runEvery(VERSION_VACUUM_INTERVAL, async_func([]() -> Task<> { co_await vacuumRetiredVersions(); }));
     }
 }
\ No newline at end of file
@@ -4,4 +4,6 @@
 
 namespace service {
     drogon::Task<> cleanupLoadingDeployments();
+
+    void scheduleVersionVacuum();
 }
\ No newline at end of file
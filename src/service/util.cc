@@ -5,6 +5,7 @@
 #include <fstream>
 #include <ranges>
 #include <regex>
+#include <shared_mutex>
 
 using namespace drogon;
 using namespace drogon_model::postgres;
@@ -19,8 +20,9 @@ TableQueryParams getTableQueryParams(const HttpRequestPtr &req) {
 }
 
 HttpResponsePtr jsonResponse(const nlohmann::json &json) {
-    const auto resp = HttpResponse::newHttpJsonResponse(unparkourJson(json));
-    resp->setStatusCode(k200OK);
+    // Serialize straight into the body instead of going through jsoncpp
+    const auto resp = HttpResponse::newHttpResponse(k200OK, CT_APPLICATION_JSON);
+    resp->setBody(json.dump());
     return resp;
 }
 
@@ -210,16 +212,98 @@ Task<TaskResult<std::pair<HttpResponsePtr, Json::Value>>> sendRawApiRequest(cons
 
 nlohmann::json parkourJson(const Json::Value &json) {
     // Jump from one json library to the other. Parkour!
-    const auto ser = serializeJsonString(json);
-    return nlohmann::json::parse(ser);
+    switch (json.type()) {
+        case Json::nullValue:
+            return nullptr;
+        case Json::intValue:
+            return json.asInt64();
+        case Json::uintValue:
+            return json.asUInt64();
+        case Json::realValue:
+            return json.asDouble();
+        case Json::stringValue:
+            return json.asString();
+        case Json::booleanValue:
+            return json.asBool();
+        case Json::arrayValue: {
+            auto array = nlohmann::json::array();
+            array.get_ref<nlohmann::json::array_t &>().reserve(json.size());
+            for (const auto &item: json) {
+                array.push_back(parkourJson(item));
+            }
+            return array;
+        }
+        case Json::objectValue: {
+            auto object = nlohmann::json::object();
+            for (auto it = json.begin(); it != json.end(); ++it) {
+                object[it.name()] = parkourJson(*it);
+            }
+            return object;
+        }
+    }
+    throw std::runtime_error("Failed to convert JSON: " + serializeJsonString(json));
 }
 
 Json::Value unparkourJson(const nlohmann::json &json) {
-    const auto parsed = parseJsonString(json.dump());
-    if (!parsed) {
-        throw std::runtime_error("Failed to convert JSON: " + json.dump());
+    switch (json.type()) {
+        case nlohmann::json::value_t::null:
+        case nlohmann::json::value_t::discarded:
+            return Json::nullValue;
+        case nlohmann::json::value_t::number_integer:
+            return Json::Value(json.get<Json::Int64>());
+        case nlohmann::json::value_t::number_unsigned:
+            return Json::Value(json.get<Json::UInt64>());
+        case nlohmann::json::value_t::number_float:
+            return Json::Value(json.get<double>());
+        case nlohmann::json::value_t::string:
+            return Json::Value(json.get_ref<const std::string &>());
+        case nlohmann::json::value_t::boolean:
+            return Json::Value(json.get<bool>());
+        case nlohmann::json::value_t::array: {
+            Json::Value array(Json::arrayValue);
+            array.resize(static_cast<Json::ArrayIndex>(json.size()));
+            Json::ArrayIndex index = 0;
+            for (const auto &item: json) {
+                array[index++] = unparkourJson(item);
+            }
+            return array;
+        }
+        case nlohmann::json::value_t::object: {
+            Json::Value object(Json::objectValue);
+            for (const auto &[key, val]: json.items()) {
+                object[key] = unparkourJson(val);
+            }
+            return object;
+        }
+        default:
+            break;
+    }
+    throw std::runtime_error("Failed to convert JSON: " + json.dump());
+}
+
+std::shared_mutex jsonValidatorsMutex;
+std::unordered_map<const nlohmann::json *, std::shared_ptr<const nlohmann::json_schema::json_validator>> jsonValidators;
+
+std::shared_ptr<const nlohmann::json_schema::json_validator> getJsonValidator(const nlohmann::json &schema) {
+    {
+        std::shared_lock lock(jsonValidatorsMutex);
+        if (const auto it = jsonValidators.find(&schema); it != jsonValidators.end()) {
+            return it->second;
+        }
+    }
+
+    const auto validator = std::make_shared<nlohmann::json_schema::json_validator>();
+    validator->set_root_schema(schema);
+
+    std::unique_lock lock(jsonValidatorsMutex);
+    return jsonValidators.try_emplace(&schema, validator).first->second;
+}
+
+void compileJsonValidators(const std::vector<const nlohmann::json *> &schemas) {
+    logger.debug("Compiling {} JSON schema validators", schemas.size());
+    for (const auto schema: schemas) {
+        getJsonValidator(*schema);
     }
-    return *parsed;
 }
 
 std::optional<JsonValidationError> validateJson(const nlohmann::json &schema, const Json::Value &json) {
@@ -241,11 +325,10 @@ std::optional<JsonValidationError> validateJson(const nlohmann::json &schema, co
         std::unique_ptr<JsonValidationError> error_;
     };
 
-    nlohmann::json_schema::json_validator validator;
-    validator.set_root_schema(schema);
+    const auto validator = getJsonValidator(schema);
     try {
         CustomJsonErrorHandler err;
-        validator.validate(json, err);
+        validator->validate(json, err);
         if (const auto &error = err.getError()) {
             return *error;
         }
@@ -219,6 +219,10 @@ std::optional<T> tryParseJson(const std::string_view json) {
 nlohmann::json parkourJson(const Json::Value &json);
 Json::Value unparkourJson(const nlohmann::json &json);
 
+// Validators are compiled once per schema and shared between threads, schemas must have static storage duration
+std::shared_ptr<const nlohmann::json_schema::json_validator> getJsonValidator(const nlohmann::json &schema);
+void compileJsonValidators(const std::vector<const nlohmann::json *> &schemas);
+
 std::optional<JsonValidationError> validateJson(const nlohmann::json &schema, const Json::Value &json);
 
 std::optional<JsonValidationError> validateJson(const nlohmann::json &schema, const nlohmann::json &json);
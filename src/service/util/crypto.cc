@@ -4,7 +4,9 @@
 #include <openssl/bio.h>
 #include <openssl/buffer.h>
 #include <openssl/core_names.h>
+#include <openssl/crypto.h>
 #include <openssl/evp.h>
+#include <openssl/hmac.h>
 #include <openssl/kdf.h>
 #include <openssl/rand.h>
 #include <openssl/thread.h>
@@ -199,6 +201,28 @@ namespace crypto {
         return std::string(plaintext.begin(), plaintext.end());
     }
 
+    std::string hmacSha256Hex(const std::string &data, const std::string &key) {
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+
+        if (!HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()), reinterpret_cast<const unsigned char *>(data.data()),
+                  data.size(), digest, &length))
+        {
+            throw std::runtime_error("HMAC computation failed.");
+        }
+
+        std::ostringstream oss;
+        for (unsigned int i = 0; i < length; i++) {
+            oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+        }
+
+        return oss.str();
+    }
+
+    bool constantTimeEquals(const std::string &a, const std::string &b) {
+        return a.size() == b.size() && CRYPTO_memcmp(a.data(), b.data(), a.size()) == 0;
+    }
+
     std::string hashSecureString(std::string input, std::string salt) {
         EVP_KDF *kdf = nullptr;
         EVP_KDF_CTX *kctx = nullptr;
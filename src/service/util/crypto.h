@@ -9,4 +9,7 @@ namespace crypto {
 
     std::string encryptString(const std::string& plaintext, const std::string& key);
     std::string decryptString(const std::string& encodedCiphertext, const std::string& key);
+
+    std::string hmacSha256Hex(const std::string& data, const std::string& key);
+    bool constantTimeEquals(const std::string& a, const std::string& b);
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#!/usr/bin/env bash
+# Generates a version directory of a big project and measures checking and reading all of its files from a bundle
+# and from the directory layout.
+# Usage: bundle.sh <wiki_bench binary> [wiki_bench options...]
+#   DIRECTORIES  Number of top level directories, each with 20 subdirectories of 50 pages and a tree index,
+#                defaults to 20
+#   ITERATIONS   Number of measured passes over the files, defaults to 10
+
+set -euo pipefail
+
+BENCH="${1:?Usage: bundle.sh <wiki_bench binary> [wiki_bench options...]}"
+shift
+DIRECTORIES="${DIRECTORIES:-20}"
+ITERATIONS="${ITERATIONS:-10}"
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+VERSION="$WORK_DIR/version"
+echo "Generating a version directory of $((DIRECTORIES * 20 * 51)) files" >&2
+
+awk -v dirs="$DIRECTORIES" -v root="$VERSION" 'BEGIN {
+  for (d = 1; d <= dirs; d++) {
+    for (s = 1; s <= 20; s++) {
+      print root "/dir_" d "/sub_" s
+    }
+  }
+}' | xargs mkdir -p
+
+awk -v dirs="$DIRECTORIES" -v root="$VERSION" 'BEGIN {
+  for (d = 1; d <= dirs; d++) {
+    for (s = 1; s <= 20; s++) {
+      dir = root "/dir_" d "/sub_" s
+      for (f = 1; f <= 50; f++) {
+        file = dir "/page_" f ".mdx"
+        print "---\nid: bench:item_" d "_" s "_" f "\n---\n\n# Page " f "\n\nContent of page " f " in directory " d "/" s "." > file
+        close(file)
+      }
+      file = dir "/_meta.json"
+      print "{\"page_1\": \"Page 1\", \"page_2\": \"Page 2\"}" > file
+      close(file)
+    }
+  }
+}'
+
+"$BENCH" bundle --iterations "$ITERATIONS" "$@" "$VERSION"
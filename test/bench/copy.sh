@@ -0,0 +1,49 @@
+#!/usr/bin/env bash
+# Generates a docs tree of tens of thousands of files, like those of big projects, and measures copying it into version
+# directories on the shared deployment threads.
+# Usage: copy.sh <wiki_bench binary> [wiki_bench options...]
+#   DIRECTORIES  Number of top level directories, each with 20 subdirectories of 50 pages and 10 images,
+#                defaults to 40
+#   ITERATIONS   Number of measured copies, defaults to 5
+
+set -euo pipefail
+
+BENCH="${1:?Usage: copy.sh <wiki_bench binary> [wiki_bench options...]}"
+shift
+DIRECTORIES="${DIRECTORIES:-40}"
+ITERATIONS="${ITERATIONS:-5}"
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+DOCS="$WORK_DIR/docs"
+echo "Generating a docs tree of $((DIRECTORIES * 20 * 60)) files" >&2
+
+awk -v dirs="$DIRECTORIES" -v root="$DOCS" 'BEGIN {
+  for (d = 1; d <= dirs; d++) {
+    for (s = 1; s <= 20; s++) {
+      print root "/dir_" d "/sub_" s
+    }
+  }
+}' | xargs mkdir -p
+
+# Pages are unique, while images repeat across directories as they do across the pages of a project
+awk -v dirs="$DIRECTORIES" -v root="$DOCS" 'BEGIN {
+  for (d = 1; d <= dirs; d++) {
+    for (s = 1; s <= 20; s++) {
+      dir = root "/dir_" d "/sub_" s
+      for (f = 1; f <= 50; f++) {
+        file = dir "/page_" f ".mdx"
+        print "---\nid: bench:item_" d "_" s "_" f "\n---\n\n# Page " f "\n\nContent of page " f " in directory " d "/" s "." > file
+        close(file)
+      }
+      for (i = 1; i <= 10; i++) {
+        file = dir "/image_" i ".png"
+        printf "PNG image %d\n", i > file
+        close(file)
+      }
+    }
+  }
+}'
+
+"$BENCH" copy --iterations "$ITERATIONS" "$@" "$DOCS"
@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+# Generates a synthetic mod with many items, tags and recipes and measures ingesting it with wiki_ingest.
+# Usage: ingest.sh <wiki_ingest binary> <project id> [wiki_ingest options...]
+#   ITEMS  Number of items, each with its own page and recipe, defaults to 20000
+#   RUNS   Number of measured runs, defaults to 3
+#
+# Without --dry-run, content is ingested into staging versions of the project in the database configured through
+# the DB_* environment variables, which must not be a live database. The project's modid must equal its id.
+# Generation progress goes to stderr, the output of wiki_ingest including its JSON report to stdout.
+
+set -euo pipefail
+
+INGEST="${1:?Usage: ingest.sh <wiki_ingest binary> <project id> [wiki_ingest options...]}"
+PROJECT_ID="${2:?Usage: ingest.sh <wiki_ingest binary> <project id> [wiki_ingest options...]}"
+shift 2
+ITEMS="${ITEMS:-20000}"
+RUNS="${RUNS:-3}"
+# Every tag holds a slice of the items and includes the previous tag, so flattening follows long chains
+TAG_SIZE=50
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+root="$WORK_DIR/docs"
+data="$root/.data/$PROJECT_ID"
+mkdir -p "$root/.content/items" "$data/tags/item" "$data/recipe"
+printf '{"id": "%s", "platforms": {"modrinth": "%s"}}\n' "$PROJECT_ID" "$PROJECT_ID" >"$root/sinytra-wiki.json"
+printf -- '---\ntitle: %s\n---\n\n# %s\n' "$PROJECT_ID" "$PROJECT_ID" >"$root/index.mdx"
+
+echo "Generating $ITEMS items in $root" >&2
+for ((i = 1; i <= ITEMS; i++)); do
+  printf -- '---\nid: %s:item_%d\ntitle: Item %d\n---\n\n# Item %d\n' "$PROJECT_ID" "$i" "$i" "$i" >"$root/.content/items/item_$i.mdx"
+
+  # Shapeless recipes from the two previous items and the item's tag
+  tag=$(((i - 1) / TAG_SIZE + 1))
+  printf '{"type": "minecraft:crafting_shapeless", "ingredients": [{"item": "%s:item_%d"}, {"item": "%s:item_%d"}, {"tag": "%s:tag_%d"}], "result": {"id": "%s:item_%d", "count": 1}}\n' \
+    "$PROJECT_ID" $(((i + ITEMS - 2) % ITEMS + 1)) "$PROJECT_ID" $(((i + ITEMS - 3) % ITEMS + 1)) "$PROJECT_ID" "$tag" "$PROJECT_ID" "$i" \
+    >"$data/recipe/item_$i.json"
+done
+
+for ((tag = 1; (tag - 1) * TAG_SIZE < ITEMS; tag++)); do
+  values=()
+  for ((i = (tag - 1) * TAG_SIZE + 1; i <= tag * TAG_SIZE && i <= ITEMS; i++)); do
+    values+=("\"$PROJECT_ID:item_$i\"")
+  done
+  if ((tag > 1)); then
+    values+=("\"#$PROJECT_ID:tag_$((tag - 1))\"")
+  fi
+  (IFS=,; printf '{"values": [%s]}\n' "${values[*]}") >"$data/tags/item/tag_$tag.json"
+done
+
+echo "Ingesting $RUNS times" >&2
+"$INGEST" "$root" --project "$PROJECT_ID" --modid "$PROJECT_ID" --runs "$RUNS" --json "$@"
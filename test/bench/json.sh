@@ -0,0 +1,65 @@
+#!/usr/bin/env bash
+# Generates a large file tree and recipe payload, like those of big projects, and measures converting them between
+# the JSON libraries structurally and through the previous string round trip.
+# Usage: json.sh <wiki_bench binary> [wiki_bench options...]
+#   DIRECTORIES  Number of top level directories in the file tree, each with 20 subdirectories of 20 pages,
+#                defaults to 50
+#   RECIPES      Number of recipes in the recipe payload, defaults to 5000
+#   ITERATIONS   Number of measured conversions of each payload, defaults to 20
+
+set -euo pipefail
+
+BENCH="${1:?Usage: json.sh <wiki_bench binary> [wiki_bench options...]}"
+shift
+DIRECTORIES="${DIRECTORIES:-50}"
+RECIPES="${RECIPES:-5000}"
+ITERATIONS="${ITERATIONS:-20}"
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+echo "Generating a file tree of $((DIRECTORIES * 421)) entries and $RECIPES recipes" >&2
+
+awk -v dirs="$DIRECTORIES" '
+function entry(id, name, path, type, children) {
+  # Concatenated rather than formatted, some awk implementations limit the length of sprintf results
+  return "{\"id\": " id ", \"name\": \"" name "\", \"icon\": null, \"path\": \"" path "\", \"type\": \"" type "\", \"children\": [" children "]}"
+}
+BEGIN {
+  tree = ""
+  for (d = 1; d <= dirs; d++) {
+    subdirs = ""
+    for (s = 1; s <= 20; s++) {
+      files = ""
+      for (f = 1; f <= 20; f++) {
+        path = sprintf("dir_%d/sub_%d/page_%d", d, s, f)
+        files = files (f > 1 ? ", " : "") entry(sprintf("\"bench:item_%d_%d_%d\"", d, s, f), "Page " f, path, "file", "")
+      }
+      subdirs = subdirs (s > 1 ? ", " : "") entry("null", "Subdirectory " s, sprintf("dir_%d/sub_%d", d, s), "dir", files)
+    }
+    printf "%s", (d > 1 ? ", " : "[") entry("null", "Directory " d, "dir_" d, "dir", subdirs)
+  }
+  print "]"
+}' >"$WORK_DIR/tree.json"
+
+awk -v recipes="$RECIPES" '
+function item(i) {
+  return sprintf("{\"id\": \"bench:item_%d\", \"name\": \"Item %d\", \"project\": \"bench\", \"has_page\": true}", i, i)
+}
+function slot(input, number, count, i) {
+  return "{\"input\": " input ", \"slot\": \"" number "\", \"count\": " count ", \"items\": [" item(i) ", " item(i + 1) "], \"tag\": null}"
+}
+BEGIN {
+  for (r = 1; r <= recipes; r++) {
+    inputs = ""
+    for (s = 1; s <= 9; s++) {
+      inputs = inputs (s > 1 ? ", " : "") slot("true", s, 1, r + s)
+    }
+    printf "%s{\"id\": \"bench:recipe_%d\", \"type\": {\"id\": \"minecraft:crafting_shaped\", \"localizedName\": \"Crafting\"}, ", (r > 1 ? ", " : "["), r
+    printf "%s", "\"inputs\": [" inputs "], \"outputs\": [" slot("false", 1, 4, r) "], "
+    printf "\"summary\": {\"inputs\": [{\"count\": 9, \"item\": %s, \"tag\": null}], \"outputs\": [{\"count\": 4, \"item\": %s, \"tag\": null}]}}", item(r + 1), item(r)
+  }
+  print "]"
+}' >"$WORK_DIR/recipes.json"
+
+"$BENCH" json --iterations "$ITERATIONS" "$@" "$WORK_DIR/tree.json" "$WORK_DIR/recipes.json"
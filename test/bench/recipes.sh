@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+# Generates a large recipe set spread over the builtin recipe types and measures how fast wiki_ingest parses and
+# validates it, which is dominated by schema validation of every recipe file.
+# Usage: recipes.sh <wiki_ingest binary> <project id> [wiki_ingest options...]
+#   RECIPES  Number of recipes, defaults to 50000
+#   RUNS     Number of measured runs, defaults to 3
+#
+# Runs are dry by default so that only parsing and validation are measured. Pass --no-dry-run to ingest the recipes
+# into staging versions of the project as well, see ingest.sh for the requirements on the database.
+# Generation progress goes to stderr, the output of wiki_ingest including its JSON report to stdout.
+
+set -euo pipefail
+
+INGEST="${1:?Usage: recipes.sh <wiki_ingest binary> <project id> [wiki_ingest options...]}"
+PROJECT_ID="${2:?Usage: recipes.sh <wiki_ingest binary> <project id> [wiki_ingest options...]}"
+shift 2
+RECIPES="${RECIPES:-50000}"
+RUNS="${RUNS:-3}"
+
+options=(--dry-run)
+passthrough=()
+for arg in "$@"; do
+  if [[ "$arg" == "--no-dry-run" ]]; then
+    options=()
+  else
+    passthrough+=("$arg")
+  fi
+done
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+root="$WORK_DIR/docs"
+mkdir -p "$root/.data/$PROJECT_ID/recipe"
+printf '{"id": "%s", "platforms": {"modrinth": "%s"}}\n' "$PROJECT_ID" "$PROJECT_ID" >"$root/sinytra-wiki.json"
+printf -- '---\ntitle: %s\n---\n\n# %s\n' "$PROJECT_ID" "$PROJECT_ID" >"$root/index.mdx"
+
+echo "Generating $RECIPES recipes in $root" >&2
+awk -v recipes="$RECIPES" -v modid="$PROJECT_ID" -v dir="$root/.data/$PROJECT_ID/recipe" '
+function item(i) { return "\"" modid ":item_" i "\"" }
+BEGIN {
+  for (r = 1; r <= recipes; r++) {
+    file = dir "/recipe_" r ".json"
+    type = r % 4
+    if (type == 0) {
+      printf "{\"type\": \"minecraft:crafting_shaped\", \"pattern\": [\"AB\", \"BA\"], \"key\": {\"A\": {\"item\": %s}, \"B\": {\"tag\": \"c:ingots\"}}, \"result\": {\"id\": %s, \"count\": 2}}\n", item(r + 1), item(r) >file
+    } else if (type == 1) {
+      printf "{\"type\": \"minecraft:crafting_shapeless\", \"ingredients\": [{\"item\": %s}, {\"item\": %s}, \"#c:dusts\"], \"result\": {\"id\": %s}}\n", item(r + 1), item(r + 2), item(r) >file
+    } else if (type == 2) {
+      printf "{\"type\": \"minecraft:smelting\", \"ingredient\": {\"item\": %s}, \"result\": {\"id\": %s}, \"experience\": 0.1, \"cookingtime\": 200}\n", item(r + 1), item(r) >file
+    } else {
+      printf "{\"type\": \"minecraft:blasting\", \"ingredient\": [{\"item\": %s}, {\"tag\": \"c:ores\"}], \"result\": {\"id\": %s}, \"experience\": 0.1, \"cookingtime\": 100}\n", item(r + 1), item(r) >file
+    }
+    close(file)
+  }
+}'
+
+echo "Ingesting $RUNS times" >&2
+"$INGEST" "$root" --project "$PROJECT_ID" --modid "$PROJECT_ID" --modules recipes --runs "$RUNS" --json "${options[@]}" "${passthrough[@]}"
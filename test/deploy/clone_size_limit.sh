@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+# Deploys a local repository that is larger than the clone size limit and checks that the clone is aborted while
+# fetching, failing the deployment with a repo_too_large issue. Usage: clone_size_limit.sh [size in MiB]
+#
+# The limit counts every object received, so the oversized file sits outside of the docs directory.
+
+source "$(dirname "$0")/common.sh"
+
+PROJECT_ID="test-clone-size-limit"
+SIZE_MIB="${1:-520}"
+
+repo="$(create_repository "$PROJECT_ID" 0)"
+mkdir -p "$repo/assets"
+head -c "$((SIZE_MIB * 1024 * 1024))" /dev/urandom >"$repo/assets/random.bin"
+git -C "$repo" add -A
+git -C "$repo" commit -qm "add $SIZE_MIB MiB of incompressible data"
+register_project "$PROJECT_ID" "$repo"
+
+status="$(send_push "$(push_payload "$repo" main)")"
+[[ "$status" == "202" ]] || fail "push was rejected with status $status"
+
+deployment="$(wait_for_deployment "$PROJECT_ID" 300)"
+result="$(sql "SELECT status FROM deployment WHERE id = '$deployment'")"
+[[ "$result" == "error" ]] || fail "deployment $deployment of a $SIZE_MIB MiB repository finished with status $result"
+
+issues="$(sql "SELECT count(*) FROM project_issue WHERE deployment_id = '$deployment' AND type = 'git_clone' AND subject = 'repo_too_large'")"
+[[ "$issues" == "1" ]] || fail "deployment $deployment did not report the repository as too large"
+
+echo "OK: cloning a $SIZE_MIB MiB repository was aborted"
@@ -0,0 +1,121 @@
+#!/usr/bin/env bash
+# Helpers shared by the local deployment tests.
+#
+# The tests run against a wiki service and database started by the developer, for example through docker compose.
+#   WIKI_URL        Base URL of the service, defaults to http://localhost:8080
+#   WIKI_STORAGE    The service's storage_path, used to inspect deployed files
+#   WEBHOOK_SECRET  The service's webhook_secret
+#   DB_*            Database connection, as for the service itself
+# Repositories are created under a temporary directory and deployed through file:// URLs, which the service clones
+# directly without a network round trip.
+
+set -euo pipefail
+
+WIKI_URL="${WIKI_URL:-http://localhost:8080}"
+: "${WIKI_STORAGE:?WIKI_STORAGE must point to the service storage path}"
+: "${WEBHOOK_SECRET:?WEBHOOK_SECRET must match the service configuration}"
+: "${DB_HOST:?}" "${DB_PORT:?}" "${DB_DATABASE:?}" "${DB_USER:?}" "${DB_PASSWORD:?}"
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+fail() {
+  echo "FAIL: $*" >&2
+  exit 1
+}
+
+sql() {
+  PGPASSWORD="$DB_PASSWORD" psql -h "$DB_HOST" -p "$DB_PORT" -U "$DB_USER" -d "$DB_DATABASE" -v ON_ERROR_STOP=1 -qtAX -c "$1"
+}
+
+# write_docs <dir> <project id> <title> [<version>=<branch> ...]
+write_docs() {
+  local dir="$1" id="$2" title="$3"
+  shift 3
+
+  local versions=""
+  for entry in "$@"; do
+    versions+="${versions:+, }\"${entry%%=*}\": \"${entry#*=}\""
+  done
+
+  mkdir -p "$dir/docs"
+  cat >"$dir/docs/sinytra-wiki.json" <<JSON
+{"id": "$id", "platforms": {"modrinth": "$id"}, "versions": {$versions}}
+JSON
+  printf -- '---\ntitle: %s\n---\n\n# %s\n' "$title" "$title" >"$dir/docs/index.mdx"
+}
+
+# create_repository <project id> <version count>
+# Creates a repository whose main branch lists a version branch for each of <version count> versions.
+# Every branch has its own page title, so deployed versions can be told apart. Prints the repository path.
+create_repository() {
+  local id="$1" count="$2" repo="$WORK_DIR/$1"
+  local versions=()
+  for ((i = 1; i <= count; i++)); do
+    versions+=("1.$i=version/1.$i")
+  done
+
+  git init -q -b main "$repo"
+  git -C "$repo" config user.email "test@localhost"
+  git -C "$repo" config user.name "test"
+
+  write_docs "$repo" "$id" "main" "${versions[@]}"
+  git -C "$repo" add -A
+  git -C "$repo" commit -qm "main"
+
+  for ((i = 1; i <= count; i++)); do
+    git -C "$repo" checkout -q -b "version/1.$i" main
+    write_docs "$repo" "$id" "version 1.$i"
+    git -C "$repo" commit -qam "version 1.$i"
+  done
+  git -C "$repo" checkout -q main
+
+  echo "$repo"
+}
+
+# register_project <project id> <repository path>
+register_project() {
+  local id="$1" repo="$2"
+  # Retired like removed projects, versions are dropped by the background job
+  sql "WITH retired AS (UPDATE project_version SET live = false, retired_at = CURRENT_TIMESTAMP
+                        WHERE project_id = '$id' AND retired_at IS NULL)
+       DELETE FROM project WHERE id = '$id'"
+  sql "INSERT INTO project (id, name, source_repo, source_branch, source_path, is_community, type, platforms, is_public)
+       VALUES ('$id', '$id', 'file://$repo', 'main', '/docs', false, 'mod', '{\"modrinth\": \"$id\"}', true)"
+}
+
+# push_payload <repository path> <branch>
+push_payload() {
+  local repo="$1" branch="$2"
+  local head
+  head="$(git -C "$repo" rev-parse "$branch")"
+  printf '{"ref": "refs/heads/%s", "after": "%s", "repository": {"clone_url": "file://%s"}}' "$branch" "$head" "$repo"
+}
+
+# send_push <payload> [secret], prints the HTTP status
+send_push() {
+  local payload="$1" secret="${2:-$WEBHOOK_SECRET}"
+  local signature
+  signature="$(printf '%s' "$payload" | openssl dgst -sha256 -hmac "$secret" | sed 's/^.* //')"
+  curl -s -o /dev/null -w '%{http_code}' -X POST "$WIKI_URL/api/v1/webhooks/push" \
+    -H "Content-Type: application/json" -H "X-Hub-Signature-256: sha256=$signature" --data-binary "$payload"
+}
+
+# wait_for_deployment <project id> <timeout seconds>, prints the id of the finished deployment
+wait_for_deployment() {
+  local id="$1" timeout="$2"
+  for ((elapsed = 0; elapsed < timeout; elapsed++)); do
+    local pending
+    pending="$(sql "SELECT count(*) FROM deployment_job WHERE project_id = '$id' AND status IN ('queued', 'running')")"
+    if [[ "$pending" == "0" ]]; then
+      local deployment
+      deployment="$(sql "SELECT id FROM deployment WHERE project_id = '$id' ORDER BY created_at DESC LIMIT 1")"
+      if [[ -n "$deployment" ]]; then
+        echo "$deployment"
+        return
+      fi
+    fi
+    sleep 1
+  done
+  fail "deployment of $id did not finish within $timeout seconds"
+}
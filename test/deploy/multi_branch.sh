@@ -0,0 +1,35 @@
+#!/usr/bin/env bash
+# Deploys a locally generated repository with many version branches and checks that every version was materialized
+# from its own branch. Usage: multi_branch.sh [version count]
+#
+# Versions are checked out and copied in parallel, so a count above the worker limit also covers workers picking up
+# several versions each.
+
+source "$(dirname "$0")/common.sh"
+
+PROJECT_ID="test-multi-branch"
+VERSIONS="${1:-10}"
+
+repo="$(create_repository "$PROJECT_ID" "$VERSIONS")"
+register_project "$PROJECT_ID" "$repo"
+
+status="$(send_push "$(push_payload "$repo" main)")"
+[[ "$status" == "202" ]] || fail "push was rejected with status $status"
+
+deployment="$(wait_for_deployment "$PROJECT_ID" 120)"
+result="$(sql "SELECT status FROM deployment WHERE id = '$deployment'")"
+[[ "$result" == "success" ]] || fail "deployment $deployment finished with status $result"
+
+root="$WIKI_STORAGE/$PROJECT_ID/$deployment"
+grep -q "# main" "$root/latest/index.mdx" || fail "default version is missing from $root"
+
+for ((i = 1; i <= VERSIONS; i++)); do
+  page="$root/1.$i/index.mdx"
+  [[ -f "$page" ]] || fail "version 1.$i is missing from $root"
+  grep -q "# version 1.$i" "$page" || fail "version 1.$i was not checked out from its own branch"
+done
+
+versions="$(sql "SELECT count(*) FROM project_version WHERE project_id = '$PROJECT_ID' AND name IS NOT NULL")"
+[[ "$versions" == "$VERSIONS" ]] || fail "expected $VERSIONS project versions, found $versions"
+
+echo "OK: deployed $VERSIONS versions of $PROJECT_ID"
@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+# Sends a burst of pushes to the webhook and checks that they are coalesced into a single deployment of the last
+# revision, and that pushes with an invalid signature are rejected. Usage: push_coalescing.sh [push count]
+#
+# All pushes must arrive within the deployment delay of the first one, which holds for local repositories.
+
+source "$(dirname "$0")/common.sh"
+
+PROJECT_ID="test-push-coalescing"
+PUSHES="${1:-5}"
+
+repo="$(create_repository "$PROJECT_ID" 0)"
+register_project "$PROJECT_ID" "$repo"
+
+status="$(send_push "$(push_payload "$repo" main)" "not-the-secret")"
+[[ "$status" == "403" ]] || fail "push with an invalid signature was answered with status $status"
+queued="$(sql "SELECT count(*) FROM deployment_job WHERE project_id = '$PROJECT_ID'")"
+[[ "$queued" == "0" ]] || fail "push with an invalid signature queued a deployment"
+
+for ((i = 1; i <= PUSHES; i++)); do
+  write_docs "$repo" "$PROJECT_ID" "revision $i"
+  git -C "$repo" commit -qam "revision $i"
+
+  status="$(send_push "$(push_payload "$repo" main)")"
+  [[ "$status" == "202" ]] || fail "push $i was rejected with status $status"
+done
+head="$(git -C "$repo" rev-parse main)"
+
+deployment="$(wait_for_deployment "$PROJECT_ID" 120)"
+count="$(sql "SELECT count(*) FROM deployment WHERE project_id = '$PROJECT_ID'")"
+[[ "$count" == "1" ]] || fail "$PUSHES pushes created $count deployments instead of one"
+
+result="$(sql "SELECT status FROM deployment WHERE id = '$deployment'")"
+[[ "$result" == "success" ]] || fail "deployment $deployment finished with status $result"
+revision="$(sql "SELECT revision->>'fullHash' FROM deployment WHERE id = '$deployment'")"
+[[ "$revision" == "$head" ]] || fail "deployment $deployment is at revision $revision instead of $head"
+grep -q "# revision $PUSHES" "$WIKI_STORAGE/$PROJECT_ID/$deployment/latest/index.mdx" ||
+  fail "deployed files are not from the last pushed revision"
+
+echo "OK: deployed $PUSHES pushes of $PROJECT_ID once at revision $head"
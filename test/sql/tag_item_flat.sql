@@ -0,0 +1,185 @@
+-- Compares the incrementally refreshed tag_item_flat closure with a recursive evaluation of the tag graph.
+-- Usage: psql -v ON_ERROR_STOP=1 [-v seed=<0..1>] [-v rounds=<n>] -f test/sql/tag_item_flat.sql <database>
+--
+-- Every round generates a random acyclic tag graph spanning several versions of two projects, with tags that include
+-- tags of other versions, and refreshes the closure version by version as deployments do. It then changes the content
+-- of a version that others depend on and refreshes only that version. The whole run is rolled back, but it creates
+-- partitions and takes locks on the content tables, so do not run it against a live database.
+
+\set ON_ERROR_STOP on
+\if :{?seed}
+\else
+\set seed 0.5
+\endif
+\if :{?rounds}
+\else
+\set rounds 5
+\endif
+
+BEGIN;
+
+SELECT setseed(:seed);
+
+-- Items reachable from every tag of the versions, following tag includes through the enumerated paths. Graphs are
+-- acyclic, so the enumeration terminates without deduplicating like the closure refresh does.
+CREATE FUNCTION pg_temp.expected_tag_item_flat(versions bigint[])
+    RETURNS TABLE
+            (
+                parent           bigint,
+                version_id       bigint,
+                child            bigint,
+                child_version_id bigint
+            )
+AS
+$BODY$
+WITH RECURSIVE tag_hierarchy(parent, version_id, child, track) AS (SELECT ptag.id, ptag.version_id, ptag.id, ARRAY [ptag.id]
+                                                                   FROM project_tag ptag
+                                                                   WHERE ptag.version_id = ANY (versions)
+                                                                   UNION ALL
+                                                                   SELECT th.parent, th.version_id, tag_tag.child, th.track || tag_tag.child
+                                                                   FROM tag_hierarchy th
+                                                                            JOIN tag_tag ON tag_tag.parent = th.child)
+SELECT DISTINCT th.parent, th.version_id, tag_item.item_id, tag_item.item_version_id
+FROM tag_hierarchy th
+         JOIN tag_item ON tag_item.tag_id = th.child;
+$BODY$ LANGUAGE sql STABLE;
+
+CREATE FUNCTION pg_temp.check_tag_item_flat(versions bigint[], stage text) RETURNS void AS
+$BODY$
+DECLARE
+    missing bigint;
+    extra   bigint;
+BEGIN
+    SELECT count(*)
+    INTO missing
+    FROM (SELECT *
+          FROM pg_temp.expected_tag_item_flat(versions)
+          EXCEPT
+          SELECT parent, version_id, child, child_version_id
+          FROM tag_item_flat
+          WHERE version_id = ANY (versions)) diff;
+
+    SELECT count(*)
+    INTO extra
+    FROM (SELECT parent, version_id, child, child_version_id
+          FROM tag_item_flat
+          WHERE version_id = ANY (versions)
+          EXCEPT
+          SELECT *
+          FROM pg_temp.expected_tag_item_flat(versions)) diff;
+
+    IF missing > 0 OR extra > 0 THEN
+        RAISE EXCEPTION 'tag_item_flat differs after %: % entries missing, % unexpected', stage, missing, extra;
+    END IF;
+END;
+$BODY$ LANGUAGE plpgsql;
+
+-- Fills a version with items and tags, where tags include items of the version and of older versions, as well as
+-- tags of the version with a higher index and tags of older versions. Both keep the graph acyclic.
+CREATE FUNCTION pg_temp.generate_version(version bigint, older bigint[], tags int, items int, density float8) RETURNS void AS
+$BODY$
+BEGIN
+    PERFORM create_version_partitions(version);
+
+    INSERT INTO project_item (item_id, version_id)
+    SELECT item.id, version
+    FROM item
+    WHERE item.loc LIKE 'flattest:item_%'
+      AND split_part(item.loc, '_', 2)::int <= items;
+
+    INSERT INTO project_tag (tag_id, version_id)
+    SELECT tag.id, version
+    FROM tag
+    WHERE tag.loc LIKE 'flattest:tag_%'
+      AND split_part(tag.loc, '_', 2)::int <= tags;
+
+    INSERT INTO tag_item (tag_id, version_id, item_id, item_version_id)
+    SELECT ptag.id, version, pitem.id, pitem.version_id
+    FROM project_tag ptag
+             CROSS JOIN project_item pitem
+    WHERE ptag.version_id = version
+      AND (pitem.version_id = version OR pitem.version_id = ANY (older))
+      AND random() < density / 4;
+
+    INSERT INTO tag_tag (parent, version_id, child, child_version_id)
+    SELECT tp.id, version, tc.id, tc.version_id
+    FROM project_tag tp
+             JOIN tag p ON p.id = tp.tag_id
+             CROSS JOIN project_tag tc
+             JOIN tag c ON c.id = tc.tag_id
+    WHERE tp.version_id = version
+      AND ((tc.version_id = version AND split_part(p.loc, '_', 2)::int < split_part(c.loc, '_', 2)::int)
+        OR tc.version_id = ANY (older))
+      AND random() < density;
+END;
+$BODY$ LANGUAGE plpgsql;
+
+CREATE FUNCTION pg_temp.run_round(round int) RETURNS void AS
+$BODY$
+DECLARE
+    density  float8 := 0.02 + random() * 0.08;
+    versions bigint[] := '{}';
+    version  bigint;
+    base     bigint;
+BEGIN
+    DELETE FROM project WHERE id IN ('flattest-base', 'flattest-addon');
+    INSERT INTO project (id, name, source_repo, source_branch, source_path, is_community, type, platforms, is_public)
+    VALUES ('flattest-base', 'flattest-base', '', 'main', '/docs', false, 'mod', '{}', false),
+           ('flattest-addon', 'flattest-addon', '', 'main', '/docs', false, 'mod', '{}', false);
+
+    -- An older and a newer version of a base project, then versions of an addon depending on both
+    FOR i IN 1..5
+        LOOP
+            INSERT INTO project_version (project_id, name, branch)
+            VALUES (CASE WHEN i <= 2 THEN 'flattest-base' ELSE 'flattest-addon' END, 'round' || round || '-' || i, 'main')
+            RETURNING id INTO version;
+
+            PERFORM pg_temp.generate_version(version, versions, 20 + (random() * 30)::int, 30 + (random() * 50)::int, density);
+            PERFORM refresh_tag_item_flat(version);
+            versions := versions || version;
+
+            PERFORM pg_temp.check_tag_item_flat(versions, format('round %s, refresh of version %s', round, i));
+        END LOOP;
+
+    -- Redeploying a base version changes what tags of the addon versions include
+    base := versions[1];
+
+    DELETE FROM tag_item WHERE tag_item.version_id = base AND random() < 0.3;
+    DELETE FROM tag_tag WHERE tag_tag.version_id = base AND random() < 0.3;
+
+    INSERT INTO tag_item (tag_id, version_id, item_id, item_version_id)
+    SELECT ptag.id, base, pitem.id, base
+    FROM project_tag ptag
+             CROSS JOIN project_item pitem
+    WHERE ptag.version_id = base
+      AND pitem.version_id = base
+      AND random() < density / 4
+    ON CONFLICT DO NOTHING;
+
+    PERFORM refresh_tag_item_flat(base);
+    PERFORM pg_temp.check_tag_item_flat(versions, format('round %s, changes to a base version', round));
+
+    -- Flattened entries of the version's own tags are rebuilt from scratch as well
+    DELETE FROM tag_item_flat WHERE tag_item_flat.version_id = versions[3];
+    PERFORM refresh_tag_item_flat(versions[3]);
+    PERFORM pg_temp.check_tag_item_flat(versions, format('round %s, rebuild of an addon version', round));
+
+    RAISE NOTICE 'Round % passed with % flattened entries', round,
+        (SELECT count(*) FROM tag_item_flat WHERE tag_item_flat.version_id = ANY (versions));
+END;
+$BODY$ LANGUAGE plpgsql;
+
+INSERT INTO item (loc)
+SELECT 'flattest:item_' || i
+FROM generate_series(1, 80) i
+ON CONFLICT DO NOTHING;
+
+INSERT INTO tag (loc)
+SELECT 'flattest:tag_' || i
+FROM generate_series(1, 50) i
+ON CONFLICT DO NOTHING;
+
+SELECT pg_temp.run_round(round)
+FROM generate_series(1, :rounds) round;
+
+ROLLBACK;